@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// Accurate summation modes for large float/double reductions.
+// Build WITHOUT -ffast-math, otherwise the compensation terms are optimized away:
+//   gcc -O2 -march=native accurate_sum.c -o accurate_sum -lm
+// Usage: ./accurate_sum [N] [ones|random]
+
+#define LANES 8
+#define PAIRWISE_BLOCK 128
+
+typedef float  vfloat  __attribute__((vector_size(LANES * sizeof(float))));
+typedef double vdouble __attribute__((vector_size(LANES * sizeof(double))));
+
+/* ---------------- float modes ---------------- */
+
+float sum_naive_f(const float *a, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+double sum_double_acc_f(const float *a, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+// Pairwise: plain loop on small blocks, recursive halving above that.
+// Error grows as O(log n) instead of O(n).
+float sum_pairwise_f(const float *a, size_t n) {
+    if (n <= PAIRWISE_BLOCK) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; i++)
+            sum += a[i];
+        return sum;
+    }
+    size_t half = n / 2;
+    return sum_pairwise_f(a, half) + sum_pairwise_f(a + half, n - half);
+}
+
+float sum_kahan_f(const float *a, size_t n) {
+    float sum = 0.0f, c = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        float y = a[i] - c;
+        float t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+    }
+    return sum;
+}
+
+// Neumaier: also correct when the new term is larger than the running sum.
+// Each float error term is exact, but their float sum would drift over long
+// runs, so the compensation is accumulated in double and folded in at the end.
+float sum_neumaier_f(const float *a, size_t n) {
+    float sum = 0.0f;
+    double c = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        float t = sum + a[i];
+        if (fabsf(sum) >= fabsf(a[i]))
+            c += (sum - t) + a[i];
+        else
+            c += (a[i] - t) + sum;
+        sum = t;
+    }
+    return (float)(sum + c);
+}
+
+// Vectorized Kahan: LANES independent (sum, c) pairs, one per SIMD lane.
+// Lanes are folded at the end with Neumaier so the merge stays accurate.
+float sum_kahan_simd_f(const float *a, size_t n) {
+    vfloat s = {0}, c = {0};
+    size_t limit = n - (n % LANES);
+    for (size_t i = 0; i < limit; i += LANES) {
+        vfloat x;
+        memcpy(&x, a + i, sizeof(x));
+        vfloat y = x - c;
+        vfloat t = s + y;
+        c = (t - s) - y;
+        s = t;
+    }
+
+    float lanes[2 * LANES + LANES];
+    int k = 0;
+    for (int l = 0; l < LANES; l++) {
+        lanes[k++] = s[l];
+        lanes[k++] = -c[l];
+    }
+    for (size_t i = limit; i < n; i++)
+        lanes[k++] = a[i];
+    return sum_neumaier_f(lanes, k);
+}
+
+/* ---------------- double modes ---------------- */
+
+double sum_naive_d(const double *a, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+double sum_pairwise_d(const double *a, size_t n) {
+    if (n <= PAIRWISE_BLOCK) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; i++)
+            sum += a[i];
+        return sum;
+    }
+    size_t half = n / 2;
+    return sum_pairwise_d(a, half) + sum_pairwise_d(a + half, n - half);
+}
+
+double sum_neumaier_d(const double *a, size_t n) {
+    double sum = 0.0, c = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double t = sum + a[i];
+        if (fabs(sum) >= fabs(a[i]))
+            c += (sum - t) + a[i];
+        else
+            c += (a[i] - t) + sum;
+        sum = t;
+    }
+    return sum + c;
+}
+
+double sum_kahan_simd_d(const double *a, size_t n) {
+    vdouble s = {0}, c = {0};
+    size_t limit = n - (n % LANES);
+    for (size_t i = 0; i < limit; i += LANES) {
+        vdouble x;
+        memcpy(&x, a + i, sizeof(x));
+        vdouble y = x - c;
+        vdouble t = s + y;
+        c = (t - s) - y;
+        s = t;
+    }
+
+    double lanes[2 * LANES + LANES];
+    int k = 0;
+    for (int l = 0; l < LANES; l++) {
+        lanes[k++] = s[l];
+        lanes[k++] = -c[l];
+    }
+    for (size_t i = limit; i < n; i++)
+        lanes[k++] = a[i];
+    return sum_neumaier_d(lanes, k);
+}
+
+/* ---------------- reference + timing ---------------- */
+
+// long double Neumaier, used as the "exact" value
+long double sum_reference(const double *a, size_t n) {
+    long double sum = 0.0L, c = 0.0L;
+    for (size_t i = 0; i < n; i++) {
+        long double x = a[i];
+        long double t = sum + x;
+        if (fabsl(sum) >= fabsl(x))
+            c += (sum - t) + x;
+        else
+            c += (x - t) + sum;
+        sum = t;
+    }
+    return sum + c;
+}
+
+double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+#define REPS 5
+
+#define BENCH(name, expr, bytes, ref) do {                                   \
+    double best = 1e30; double result = 0.0;                                 \
+    for (int rep = 0; rep < REPS; rep++) {                                   \
+        double t1 = now();                                                   \
+        result = (double)(expr);                                             \
+        double dt = now() - t1;                                              \
+        if (dt < best) best = dt;                                            \
+    }                                                                        \
+    double rel = fabs((double)((long double)result - (ref)) / (double)(ref)); \
+    printf("%-18s | Sum=%22.6f | RelErr=%.3e | Time=%9.3f ms | %7.2f GB/s\n", \
+           name, result, rel, best * 1e3, (bytes) / best * 1e-9);            \
+} while (0)
+
+int main(int argc, char *argv[]) {
+    size_t n = 100000000ULL;
+    int random_input = 0;
+
+    if (argc > 1) n = strtoull(argv[1], NULL, 10);
+    if (argc > 2) random_input = (strcmp(argv[2], "random") == 0);
+
+    float  *af = malloc(n * sizeof(float));
+    double *ad = malloc(n * sizeof(double));
+    if (!af || !ad) {
+        fprintf(stderr, "malloc failed\n");
+        return 1;
+    }
+
+    srand(0);
+    for (size_t i = 0; i < n; i++) {
+        // random: positive values spanning 6 decades, like noisy telemetry
+        float v = random_input ? (float)pow(10.0, 6.0 * rand() / RAND_MAX - 3.0) : 1.0f;
+        af[i] = v;
+        ad[i] = v;
+    }
+
+    long double ref = sum_reference(ad, n);
+    printf("N=%zu | Input=%s | Reference=%.6Lf\n", n, random_input ? "random" : "ones", ref);
+
+    double fbytes = (double)n * sizeof(float);
+    double dbytes = (double)n * sizeof(double);
+
+    printf("---- float input ----\n");
+    BENCH("naive_float",    sum_naive_f(af, n),      fbytes, ref);
+    BENCH("double_acc",     sum_double_acc_f(af, n), fbytes, ref);
+    BENCH("pairwise",       sum_pairwise_f(af, n),   fbytes, ref);
+    BENCH("kahan",          sum_kahan_f(af, n),      fbytes, ref);
+    BENCH("neumaier",       sum_neumaier_f(af, n),   fbytes, ref);
+    BENCH("kahan_simd",     sum_kahan_simd_f(af, n), fbytes, ref);
+
+    printf("---- double input ----\n");
+    BENCH("naive_double",   sum_naive_d(ad, n),      dbytes, ref);
+    BENCH("pairwise",       sum_pairwise_d(ad, n),   dbytes, ref);
+    BENCH("neumaier",       sum_neumaier_d(ad, n),   dbytes, ref);
+    BENCH("kahan_simd",     sum_kahan_simd_d(ad, n), dbytes, ref);
+
+    free(af);
+    free(ad);
+    return 0;
+}
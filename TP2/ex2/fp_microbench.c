@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <immintrin.h>
+
+// FP latency / reciprocal-throughput microbenchmarks (generalizes ex2).
+// For every op (add, mul, fma, div, sqrt) x type (float, double) x form
+// (scalar, packed SIMD), run K independent dependency chains for K = 1..16:
+//   K = 1           -> latency (cycles per op)
+//   min over K      -> reciprocal throughput (cycles per instruction)
+//   smallest K within 5% of that minimum -> accumulators needed to saturate
+// Cycles come from a calibration chain of 1-cycle integer adds, so the
+// numbers are core cycles even with turbo enabled.
+//
+// x86-64 only. Vectorization must stay off so each chain stays a chain:
+//   gcc -O2 -march=native -fno-tree-vectorize -fno-math-errno fp_microbench.c -o fp_microbench -lm
+// The fma rows need an FMA target (__FMA__); without it they are left out.
+// Usage: ./fp_microbench [ops_per_run] [csv]
+
+#define MAX_K 16
+
+#if defined(__AVX__)
+#define PACKED_BITS 256
+typedef __m256  vps;
+typedef __m256d vpd;
+#define PS_SET1  _mm256_set1_ps
+#define PD_SET1  _mm256_set1_pd
+#define PS_ADD   _mm256_add_ps
+#define PD_ADD   _mm256_add_pd
+#define PS_MUL   _mm256_mul_ps
+#define PD_MUL   _mm256_mul_pd
+#define PS_DIV   _mm256_div_ps
+#define PD_DIV   _mm256_div_pd
+#define PS_SQRT  _mm256_sqrt_ps
+#define PD_SQRT  _mm256_sqrt_pd
+#define PS_FIRST(v) _mm256_cvtss_f32(v)
+#define PD_FIRST(v) _mm256_cvtsd_f64(v)
+#ifdef __FMA__
+#define PS_FMA   _mm256_fmadd_ps
+#define PD_FMA   _mm256_fmadd_pd
+#endif
+#else
+#define PACKED_BITS 128
+typedef __m128  vps;
+typedef __m128d vpd;
+#define PS_SET1  _mm_set1_ps
+#define PD_SET1  _mm_set1_pd
+#define PS_ADD   _mm_add_ps
+#define PD_ADD   _mm_add_pd
+#define PS_MUL   _mm_mul_ps
+#define PD_MUL   _mm_mul_pd
+#define PS_DIV   _mm_div_ps
+#define PD_DIV   _mm_div_pd
+#define PS_SQRT  _mm_sqrt_ps
+#define PD_SQRT  _mm_sqrt_pd
+#define PS_FIRST(v) _mm_cvtss_f32(v)
+#define PD_FIRST(v) _mm_cvtsd_f64(v)
+#ifdef __FMA__
+#define PS_FMA   _mm_fmadd_ps
+#define PD_FMA   _mm_fmadd_pd
+#endif
+#endif
+
+// Keeps the compiler from merging or hoisting chains; emits no instruction
+#define KEEP(x) __asm__ volatile("" : "+x"(x))
+
+volatile double sink;
+
+double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Core frequency from a chain of dependent 1-cycle integer adds
+double calibrate_ghz(void) {
+    const long iters = 50000000;
+    unsigned long x = 0, one = 1;
+    double best = 1e30;
+    for (int rep = 0; rep < 3; rep++) {
+        double t0 = now();
+        for (long i = 0; i < iters; i++) {
+            __asm__ volatile(
+                "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\t"
+                "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0"
+                : "+r"(x) : "r"(one));
+        }
+        double dt = now() - t0;
+        if (dt < best) best = dt;
+    }
+    sink = (double)x;
+    return iters * 8.0 / best * 1e-9;
+}
+
+// Generates bench_<name>(K, iters): K chains of OP over type T, returns
+// seconds for iters * K dependent operations. The accumulators are separate
+// named variables (not an array) so they stay in registers for every K.
+#define STEP(j, OP) if ((j) < K) { a##j = OP(a##j); KEEP(a##j); }
+#define ALL_STEPS(OP) STEP(0, OP) STEP(1, OP) STEP(2, OP) STEP(3, OP)       \
+    STEP(4, OP) STEP(5, OP) STEP(6, OP) STEP(7, OP) STEP(8, OP) STEP(9, OP)  \
+    STEP(10, OP) STEP(11, OP) STEP(12, OP) STEP(13, OP) STEP(14, OP) STEP(15, OP)
+
+#define DEFINE_BENCH(name, T, INIT, OP, FIRST)                                \
+static inline __attribute__((always_inline))                                  \
+double name##_k(const int K, long iters) {                                    \
+    T a0 = INIT(0),   a1 = INIT(1),   a2 = INIT(2),   a3 = INIT(3);           \
+    T a4 = INIT(4),   a5 = INIT(5),   a6 = INIT(6),   a7 = INIT(7);           \
+    T a8 = INIT(8),   a9 = INIT(9),   a10 = INIT(10), a11 = INIT(11);         \
+    T a12 = INIT(12), a13 = INIT(13), a14 = INIT(14), a15 = INIT(15);         \
+    double t0 = now();                                                        \
+    for (long i = 0; i < iters; i++) {                                        \
+        ALL_STEPS(OP)                                                         \
+    }                                                                         \
+    double dt = now() - t0;                                                   \
+    sink = FIRST(a0) + FIRST(a1) + FIRST(a2) + FIRST(a3) + FIRST(a4)          \
+         + FIRST(a5) + FIRST(a6) + FIRST(a7) + FIRST(a8) + FIRST(a9)          \
+         + FIRST(a10) + FIRST(a11) + FIRST(a12) + FIRST(a13) + FIRST(a14)     \
+         + FIRST(a15);                                                        \
+    return dt;                                                                \
+}                                                                             \
+double bench_##name(int K, long iters) {                                      \
+    switch (K) {                                                              \
+    case 1:  return name##_k(1, iters);   case 2:  return name##_k(2, iters);  \
+    case 3:  return name##_k(3, iters);   case 4:  return name##_k(4, iters);  \
+    case 5:  return name##_k(5, iters);   case 6:  return name##_k(6, iters);  \
+    case 7:  return name##_k(7, iters);   case 8:  return name##_k(8, iters);  \
+    case 9:  return name##_k(9, iters);   case 10: return name##_k(10, iters); \
+    case 11: return name##_k(11, iters);  case 12: return name##_k(12, iters); \
+    case 13: return name##_k(13, iters);  case 14: return name##_k(14, iters); \
+    case 15: return name##_k(15, iters);  default: return name##_k(16, iters); \
+    }                                                                         \
+}
+
+/* ---------------- operations ---------------- */
+// Constants keep every chain finite and away from denormals.
+
+#define ID(x) (x)
+#define INIT_F(k)   (1.0f + 0.01f * (k))
+#define INIT_D(k)   (1.0 + 0.01 * (k))
+#define INIT_PS(k)  PS_SET1(1.0f + 0.01f * (k))
+#define INIT_PD(k)  PD_SET1(1.0 + 0.01 * (k))
+
+#define ADD_F(x)   ((x) + 1e-7f)
+#define MUL_F(x)   ((x) * 0.9999999f)
+#define DIV_F(x)   ((x) / 1.0000001f)
+#define SQRT_F(x)  sqrtf(x)
+
+#define ADD_D(x)   ((x) + 1e-7)
+#define MUL_D(x)   ((x) * 0.9999999)
+#define DIV_D(x)   ((x) / 1.0000001)
+#define SQRT_D(x)  sqrt(x)
+
+#define ADD_PS(x)  PS_ADD((x), PS_SET1(1e-7f))
+#define MUL_PS(x)  PS_MUL((x), PS_SET1(0.9999999f))
+#define DIV_PS(x)  PS_DIV((x), PS_SET1(1.0000001f))
+#define SQRT_PS(x) PS_SQRT(x)
+#define ADD_PD(x)  PD_ADD((x), PD_SET1(1e-7))
+#define MUL_PD(x)  PD_MUL((x), PD_SET1(0.9999999))
+#define DIV_PD(x)  PD_DIV((x), PD_SET1(1.0000001))
+#define SQRT_PD(x) PD_SQRT(x)
+// Without hardware FMA, fma()/fmaf() are libm software calls, so every FMA
+// row is only built when the compiler targets FMA (-march=native on an FMA
+// machine, or -mfma)
+#ifdef __FMA__
+#define FMA_F(x)   fmaf((x), 0.999999f, 1e-6f)
+#define FMA_D(x)   fma((x), 0.999999, 1e-6)
+#define FMA_PS(x)  PS_FMA((x), PS_SET1(0.999999f), PS_SET1(1e-6f))
+#define FMA_PD(x)  PD_FMA((x), PD_SET1(0.999999), PD_SET1(1e-6))
+#endif
+
+DEFINE_BENCH(add_f,  float,  INIT_F, ADD_F,  ID)
+DEFINE_BENCH(mul_f,  float,  INIT_F, MUL_F,  ID)
+DEFINE_BENCH(div_f,  float,  INIT_F, DIV_F,  ID)
+DEFINE_BENCH(sqrt_f, float,  INIT_F, SQRT_F, ID)
+DEFINE_BENCH(add_d,  double, INIT_D, ADD_D,  ID)
+DEFINE_BENCH(mul_d,  double, INIT_D, MUL_D,  ID)
+DEFINE_BENCH(div_d,  double, INIT_D, DIV_D,  ID)
+DEFINE_BENCH(sqrt_d, double, INIT_D, SQRT_D, ID)
+
+DEFINE_BENCH(add_ps,  vps, INIT_PS, ADD_PS,  PS_FIRST)
+DEFINE_BENCH(mul_ps,  vps, INIT_PS, MUL_PS,  PS_FIRST)
+DEFINE_BENCH(div_ps,  vps, INIT_PS, DIV_PS,  PS_FIRST)
+DEFINE_BENCH(sqrt_ps, vps, INIT_PS, SQRT_PS, PS_FIRST)
+DEFINE_BENCH(add_pd,  vpd, INIT_PD, ADD_PD,  PD_FIRST)
+DEFINE_BENCH(mul_pd,  vpd, INIT_PD, MUL_PD,  PD_FIRST)
+DEFINE_BENCH(div_pd,  vpd, INIT_PD, DIV_PD,  PD_FIRST)
+DEFINE_BENCH(sqrt_pd, vpd, INIT_PD, SQRT_PD, PD_FIRST)
+#ifdef __FMA__
+DEFINE_BENCH(fma_f,  float,  INIT_F, FMA_F,  ID)
+DEFINE_BENCH(fma_d,  double, INIT_D, FMA_D,  ID)
+DEFINE_BENCH(fma_ps,  vps, INIT_PS, FMA_PS,  PS_FIRST)
+DEFINE_BENCH(fma_pd,  vpd, INIT_PD, FMA_PD,  PD_FIRST)
+#endif
+
+typedef struct {
+    const char *op;
+    const char *type;
+    int lanes;
+    double (*fn)(int, long);
+} bench_t;
+
+bench_t benches[] = {
+    {"add",  "float",  1, bench_add_f},  {"mul",  "float",  1, bench_mul_f},
+#ifdef __FMA__
+    {"fma",  "float",  1, bench_fma_f},
+#endif
+    {"div",  "float",  1, bench_div_f},  {"sqrt", "float",  1, bench_sqrt_f},
+    {"add",  "double", 1, bench_add_d},  {"mul",  "double", 1, bench_mul_d},
+#ifdef __FMA__
+    {"fma",  "double", 1, bench_fma_d},
+#endif
+    {"div",  "double", 1, bench_div_d},
+    {"sqrt", "double", 1, bench_sqrt_d},
+    {"add",  "float",  PACKED_BITS / 32, bench_add_ps},
+    {"mul",  "float",  PACKED_BITS / 32, bench_mul_ps},
+#ifdef __FMA__
+    {"fma",  "float",  PACKED_BITS / 32, bench_fma_ps},
+#endif
+    {"div",  "float",  PACKED_BITS / 32, bench_div_ps},
+    {"sqrt", "float",  PACKED_BITS / 32, bench_sqrt_ps},
+    {"add",  "double", PACKED_BITS / 64, bench_add_pd},
+    {"mul",  "double", PACKED_BITS / 64, bench_mul_pd},
+#ifdef __FMA__
+    {"fma",  "double", PACKED_BITS / 64, bench_fma_pd},
+#endif
+    {"div",  "double", PACKED_BITS / 64, bench_div_pd},
+    {"sqrt", "double", PACKED_BITS / 64, bench_sqrt_pd},
+};
+
+int main(int argc, char *argv[]) {
+    long ops = 20000000;
+    int csv = 0;
+
+    if (argc > 1) ops = atol(argv[1]);
+    if (argc > 2) csv = 1;
+
+    double ghz = calibrate_ghz();
+    int nb = sizeof(benches) / sizeof(benches[0]);
+
+    if (csv) {
+        printf("Op,Type,Lanes,K,Cycles_per_instr\n");
+    } else {
+        printf("Core clock: %.2f GHz (from 1-cycle add chain), packed = %d-bit\n", ghz, PACKED_BITS);
+        printf("Cycles per instruction with K independent chains:\n");
+        printf("%-5s %-6s %5s | %8s %8s %5s %9s |", "op", "type", "lanes",
+               "latency", "rthru", "K*", "flop/cyc");
+        for (int k = 1; k <= MAX_K; k++) printf("  K=%-2d", k);
+        printf("\n");
+    }
+
+    for (int b = 0; b < nb; b++) {
+        double cyc[MAX_K + 1];
+        double best = 1e30;
+        for (int k = 1; k <= MAX_K; k++) {
+            long iters = ops / k;
+            benches[b].fn(k, iters / 10);   // warm-up
+            double dt = benches[b].fn(k, iters);
+            cyc[k] = dt * ghz * 1e9 / ((double)iters * k);
+            if (cyc[k] < best) best = cyc[k];
+        }
+        int kstar = 1;
+        while (kstar < MAX_K && cyc[kstar] > 1.05 * best) kstar++;
+
+        if (csv) {
+            for (int k = 1; k <= MAX_K; k++)
+                printf("%s,%s,%d,%d,%.3f\n", benches[b].op, benches[b].type, benches[b].lanes, k, cyc[k]);
+        } else {
+            int flops = benches[b].lanes * (benches[b].op[0] == 'f' ? 2 : 1);
+            printf("%-5s %-6s %5d | %8.2f %8.2f %5d %9.2f |",
+                   benches[b].op, benches[b].type, benches[b].lanes, cyc[1], best, kstar, flops / best);
+            for (int k = 1; k <= MAX_K; k++) printf(" %5.2f", cyc[k]);
+            printf("\n");
+        }
+    }
+    return 0;
+}
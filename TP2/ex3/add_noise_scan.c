@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+
+// Parallel-prefix evaluation of add_noise (a[i] = a[i-1] * 1.0000001).
+// The recurrence is a product scan, so it splits into:
+//   1. block-local products (one block per thread)
+//   2. exclusive scan of the block carries
+//   3. fix-up pass multiplying each block by its carry
+// Build: gcc -O2 -fopenmp add_noise_scan.c -o add_noise_scan -lm
+// Usage: ./add_noise_scan [N] [max_threads]
+
+#define FACTOR 1.0000001
+#define REPS 3
+
+// Generic in-place inclusive scan for an associative OP with identity ID.
+// Generates scan_<name>(double *x, long long n).
+#define DEFINE_SCAN(name, OP, ID)                                           \
+void scan_##name(double *x, long long n) {                                  \
+    int max_t = omp_get_max_threads();                                      \
+    double *carry = malloc((max_t + 1) * sizeof(double));                   \
+    _Pragma("omp parallel")                                                 \
+    {                                                                       \
+        int id = omp_get_thread_num();                                      \
+        int nt = omp_get_num_threads();                                     \
+        long long begin = n * id / nt;                                      \
+        long long end   = n * (id + 1) / nt;                                \
+        double acc = ID;                                                    \
+        for (long long i = begin; i < end; i++) {                           \
+            acc = acc OP x[i];                                              \
+            x[i] = acc;                                                     \
+        }                                                                   \
+        carry[id + 1] = acc;                                                \
+        _Pragma("omp barrier")                                              \
+        _Pragma("omp single")                                               \
+        {                                                                   \
+            carry[0] = ID;                                                  \
+            for (int t = 1; t <= nt; t++)                                   \
+                carry[t] = carry[t - 1] OP carry[t];                        \
+        }                                                                   \
+        double c = carry[id];                                               \
+        for (long long i = begin; i < end; i++)                             \
+            x[i] = c OP x[i];                                               \
+    }                                                                       \
+    free(carry);                                                            \
+}
+
+DEFINE_SCAN(prod, *, 1.0)
+DEFINE_SCAN(sum, +, 0.0)
+
+// Original sequential version
+void add_noise(double *a, long long n) {
+    a[0] = 1.0;
+    for (long long i = 1; i < n; i++) {
+        a[i] = a[i-1] * FACTOR;
+    }
+}
+
+// Scan version, specialized: the factors are constant, so the local pass
+// generates them on the fly instead of reading a factor array.
+void add_noise_scan(double *a, long long n) {
+    int max_t = omp_get_max_threads();
+    double *carry = malloc((max_t + 1) * sizeof(double));
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        long long begin = n * id / nt;
+        long long end   = n * (id + 1) / nt;
+
+        // 1. block-local products
+        double acc = 1.0;
+        for (long long i = begin; i < end; i++) {
+            if (i > 0) acc *= FACTOR;
+            a[i] = acc;
+        }
+        carry[id + 1] = acc;
+
+        // 2. exclusive scan of block carries
+        #pragma omp barrier
+        #pragma omp single
+        {
+            carry[0] = 1.0;
+            for (int t = 1; t <= nt; t++)
+                carry[t] *= carry[t - 1];
+        }
+
+        // 3. fix-up
+        double c = carry[id];
+        if (id > 0) {
+            for (long long i = begin; i < end; i++)
+                a[i] *= c;
+        }
+    }
+    free(carry);
+}
+
+// Same result through the generic utility: product scan of [1, f, f, ...]
+void add_noise_generic_scan(double *a, long long n) {
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        a[i] = (i == 0) ? 1.0 : FACTOR;
+    }
+    scan_prod(a, n);
+}
+
+// Closed form: a[i] = f^i, embarrassingly parallel
+void add_noise_pow(double *a, long long n) {
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        a[i] = pow(FACTOR, (double)i);
+    }
+}
+
+// Remaining ex3 phases, parallelized
+double parallel_phases(double *a, double *b, double *c, long long n) {
+    double sum = 0.0;
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        b[i] = i * 0.5;
+    }
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        c[i] = a[i] + b[i];
+    }
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long long i = 0; i < n; i++) {
+        sum += c[i];
+    }
+    return sum;
+}
+
+double max_rel_drift(const double *ref, const double *x, long long n) {
+    double drift = 0.0;
+    #pragma omp parallel for reduction(max:drift)
+    for (long long i = 0; i < n; i++) {
+        double d = fabs(x[i] - ref[i]) / ref[i];
+        if (d > drift) drift = d;
+    }
+    return drift;
+}
+
+// Least-squares Amdahl fit: 1/S - 1/p = fs * (1 - 1/p)
+double fit_serial_fraction(const int *p, const double *speedup, int count) {
+    double num = 0.0, den = 0.0;
+    for (int k = 0; k < count; k++) {
+        double u = 1.0 - 1.0 / p[k];
+        double v = 1.0 / speedup[k] - 1.0 / p[k];
+        num += u * v;
+        den += u * u;
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    long long n = 100000000LL;
+    int max_threads = omp_get_max_threads();
+
+    if (argc > 1) n = atoll(argv[1]);
+    if (argc > 2) max_threads = atoi(argv[2]);
+
+    double *ref = malloc(n * sizeof(double));
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *c = malloc(n * sizeof(double));
+
+    if (!ref || !a || !b || !c) {
+        fprintf(stderr, "Malloc failed\n");
+        return 1;
+    }
+
+    // Sanity check of the generic scans on small known inputs
+    double check[5] = {1, 2, 3, 4, 5};
+    scan_sum(check, 5);
+    add_noise_generic_scan(a, 1000 < n ? 1000 : n);
+    add_noise(ref, 1000 < n ? 1000 : n);
+    if (check[4] != 15.0 || max_rel_drift(ref, a, 1000 < n ? 1000 : n) > 1e-12) {
+        fprintf(stderr, "scan self-check failed\n");
+        return 1;
+    }
+
+    int threads[64];
+    double sp_seq[64], sp_scan[64];
+    int count = 0;
+    double base_seq = 0.0, base_scan = 0.0;
+
+    printf("Threads,add_noise_seq_s,add_noise_scan_s,add_noise_pow_s,parallel_phases_s,"
+           "scan_drift,pow_drift,total_seq_s,total_scan_s,fs_seq,fs_scan\n");
+
+    for (int t = 1; t <= max_threads && count < 64; t *= 2) {
+        omp_set_num_threads(t);
+        double t_seq = 1e30, t_scan = 1e30, t_pow = 1e30, t_par = 1e30;
+
+        for (int rep = 0; rep < REPS; rep++) {
+            double t0 = omp_get_wtime();
+            add_noise(ref, n);
+            double t1 = omp_get_wtime();
+            add_noise_pow(a, n);
+            double t2 = omp_get_wtime();
+            add_noise_scan(a, n);
+            double t3 = omp_get_wtime();
+            parallel_phases(a, b, c, n);
+            double t4 = omp_get_wtime();
+            if (t1 - t0 < t_seq)  t_seq  = t1 - t0;
+            if (t2 - t1 < t_pow)  t_pow  = t2 - t1;
+            if (t3 - t2 < t_scan) t_scan = t3 - t2;
+            if (t4 - t3 < t_par)  t_par  = t4 - t3;
+        }
+
+        double drift_scan = max_rel_drift(ref, a, n);
+        add_noise_pow(c, n);
+        double drift_pow = max_rel_drift(ref, c, n);
+
+        double total_seq  = t_seq + t_par;
+        double total_scan = t_scan + t_par;
+        if (t == 1) {
+            base_seq = total_seq;
+            base_scan = total_scan;
+        }
+        threads[count] = t;
+        sp_seq[count]  = base_seq / total_seq;
+        sp_scan[count] = base_scan / total_scan;
+        count++;
+
+        printf("%d,%.6f,%.6f,%.6f,%.6f,%.3e,%.3e,%.6f,%.6f,%.4f,%.4f\n",
+               t, t_seq, t_scan, t_pow, t_par, drift_scan, drift_pow,
+               total_seq, total_scan, t_seq / total_seq, t_scan / total_scan);
+    }
+
+    if (count > 1) {
+        printf("Amdahl fit fs (sequential add_noise): %.4f\n", fit_serial_fraction(threads, sp_seq, count));
+        printf("Amdahl fit fs (scan add_noise):       %.4f\n", fit_serial_fraction(threads, sp_scan, count));
+    }
+
+    free(ref); free(a); free(b); free(c);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+
+// Fused init_b + compute_addition + reduction.
+// Unfused, the three phases stream b and c through memory only to throw them
+// away. The fused pass keeps b and c in a small per-thread buffer (CHUNK
+// elements, L1-resident) and only streams a.
+// Bytes are counted from the loads/stores each phase performs; stores also
+// count the write-allocate read of the destination line.
+// Build: gcc -O2 -fopenmp fused_pipeline.c -o fused_pipeline -lm
+// Usage: ./fused_pipeline [N] [threads]
+
+#define CHUNK 1024
+#define REPS 3
+
+void add_noise(double *a, long long n) {
+    a[0] = 1.0;
+    for (long long i = 1; i < n; i++) {
+        a[i] = a[i-1] * 1.0000001;
+    }
+}
+
+/* ---------------- unfused (original phases) ---------------- */
+
+void init_b(double *b, long long n) {
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        b[i] = i * 0.5;
+    }
+}
+
+void compute_addition(double *a, double *b, double *c, long long n) {
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+double reduction(double *c, long long n) {
+    double sum = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long long i = 0; i < n; i++) {
+        sum += c[i];
+    }
+    return sum;
+}
+
+/* ---------------- fused ---------------- */
+
+// One pass over a; b and c only ever live in the chunk buffers
+double fused(const double *a, long long n) {
+    double sum = 0.0;
+    #pragma omp parallel reduction(+:sum)
+    {
+        double b[CHUNK], c[CHUNK];
+        #pragma omp for schedule(static)
+        for (long long start = 0; start < n; start += CHUNK) {
+            long long len = (n - start < CHUNK) ? n - start : CHUNK;
+            for (long long k = 0; k < len; k++)
+                b[k] = (start + k) * 0.5;
+            for (long long k = 0; k < len; k++)
+                c[k] = a[start + k] + b[k];
+            // 4 accumulators: the single add chain otherwise caps the pass
+            double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+            long long k = 0;
+            for (; k + 4 <= len; k += 4) {
+                s0 += c[k];
+                s1 += c[k + 1];
+                s2 += c[k + 2];
+                s3 += c[k + 3];
+            }
+            for (; k < len; k++)
+                s0 += c[k];
+            sum += (s0 + s1) + (s2 + s3);
+        }
+    }
+    return sum;
+}
+
+void report(const char *mode, int threads, const char *phase, double bytes, double t) {
+    printf("%s,%d,%s,%.0f,%.6f,%.2f\n", mode, threads, phase, bytes, t, bytes / t * 1e-9);
+}
+
+int main(int argc, char *argv[]) {
+    long long n = 100000000LL;
+    int num_threads = omp_get_max_threads();
+
+    if (argc > 1) n = atoll(argv[1]);
+    if (argc > 2) num_threads = atoi(argv[2]);
+    omp_set_num_threads(num_threads);
+
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *c = malloc(n * sizeof(double));
+
+    if (!a || !b || !c) {
+        fprintf(stderr, "Malloc failed\n");
+        return 1;
+    }
+
+    double s = (double)sizeof(double) * n;
+    double t0, t_noise, t_init = 1e30, t_add = 1e30, t_red = 1e30, t_fused = 1e30;
+    double sum_unfused = 0.0, sum_fused = 0.0;
+
+    t0 = omp_get_wtime();
+    add_noise(a, n);
+    t_noise = omp_get_wtime() - t0;
+
+    // First touch b and c so page faults are not charged to the unfused run
+    init_b(b, n);
+    compute_addition(a, b, c, n);
+
+    for (int rep = 0; rep < REPS; rep++) {
+        t0 = omp_get_wtime();
+        init_b(b, n);
+        double t1 = omp_get_wtime();
+        compute_addition(a, b, c, n);
+        double t2 = omp_get_wtime();
+        sum_unfused = reduction(c, n);
+        double t3 = omp_get_wtime();
+        sum_fused = fused(a, n);
+        double t4 = omp_get_wtime();
+
+        if (t1 - t0 < t_init)  t_init  = t1 - t0;
+        if (t2 - t1 < t_add)   t_add   = t2 - t1;
+        if (t3 - t2 < t_red)   t_red   = t3 - t2;
+        if (t4 - t3 < t_fused) t_fused = t4 - t3;
+    }
+
+    printf("Mode,Threads,Phase,Bytes,Time_s,GB_s\n");
+    report("both",    num_threads, "add_noise",        2 * s, t_noise);
+    report("unfused", num_threads, "init_b",           2 * s, t_init);
+    report("unfused", num_threads, "compute_addition", 4 * s, t_add);
+    report("unfused", num_threads, "reduction",        1 * s, t_red);
+    report("unfused", num_threads, "total",            7 * s, t_init + t_add + t_red);
+    report("fused",   num_threads, "total",            1 * s, t_fused);
+
+    printf("Sum unfused = %.15e\n", sum_unfused);
+    printf("Sum fused   = %.15e (rel diff %.3e)\n", sum_fused,
+           fabs(sum_fused - sum_unfused) / fabs(sum_unfused));
+    printf("Speedup fused vs unfused: %.2fx\n", (t_init + t_add + t_red) / t_fused);
+
+    free(a); free(b); free(c);
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <omp.h>
+
+// Producer/consumer overlap of add_noise with the parallel phases.
+// Thread 0 produces a chunk by chunk and publishes an atomic watermark
+// (number of finished chunks, release store). The other threads take chunks
+// in order from a shared counter, wait until the watermark covers them
+// (acquire load) and run init_b + compute_addition + reduction on that chunk
+// while the producer is still working on later ones.
+// Partial sums are stored per chunk and added in chunk order, so the result
+// does not depend on which worker handled which chunk.
+// Build: gcc -O2 -fopenmp pipelined_overlap.c -o pipelined_overlap -lm
+// Usage: ./pipelined_overlap [N] [threads] [chunk]
+
+#define REPS 3
+
+void add_noise(double *a, long long n) {
+    a[0] = 1.0;
+    for (long long i = 1; i < n; i++) {
+        a[i] = a[i-1] * 1.0000001;
+    }
+}
+
+double consume_chunk(const double *a, double *b, double *c, long long begin, long long end) {
+    double sum = 0.0;
+    for (long long i = begin; i < end; i++)
+        b[i] = i * 0.5;
+    for (long long i = begin; i < end; i++)
+        c[i] = a[i] + b[i];
+    for (long long i = begin; i < end; i++)
+        sum += c[i];
+    return sum;
+}
+
+// Bulk-synchronous reference: sequential add_noise, then parallel phases
+double bulk(double *a, double *b, double *c, long long n, long long chunk,
+            double *partial, double *t_noise) {
+    long long nchunks = (n + chunk - 1) / chunk;
+    double t0 = omp_get_wtime();
+    add_noise(a, n);
+    *t_noise = omp_get_wtime() - t0;
+
+    #pragma omp parallel for schedule(static)
+    for (long long k = 0; k < nchunks; k++) {
+        long long end = (k + 1) * chunk < n ? (k + 1) * chunk : n;
+        partial[k] = consume_chunk(a, b, c, k * chunk, end);
+    }
+
+    double sum = 0.0;
+    for (long long k = 0; k < nchunks; k++) sum += partial[k];
+    return sum;
+}
+
+double pipelined(double *a, double *b, double *c, long long n, long long chunk,
+                 double *partial) {
+    long long nchunks = (n + chunk - 1) / chunk;
+    atomic_llong ready = 0;     // chunks of a fully written
+    atomic_llong next = 0;      // next chunk to hand to a consumer
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        if (id == 0) {
+            // Producer: same recurrence, published one chunk at a time
+            double prev = 1.0;
+            for (long long k = 0; k < nchunks; k++) {
+                long long begin = k * chunk;
+                long long end = begin + chunk < n ? begin + chunk : n;
+                for (long long i = begin; i < end; i++) {
+                    prev = (i == 0) ? 1.0 : prev * 1.0000001;
+                    a[i] = prev;
+                }
+                atomic_store_explicit(&ready, k + 1, memory_order_release);
+            }
+        }
+
+        // Consumers; the producer joins them once all of a is published
+        for (;;) {
+            long long k = atomic_fetch_add_explicit(&next, 1, memory_order_relaxed);
+            if (k >= nchunks) break;
+            int spins = 0;
+            while (atomic_load_explicit(&ready, memory_order_acquire) <= k) {
+                if (++spins % 1024 == 0) sched_yield();
+            }
+            long long begin = k * chunk;
+            long long end = begin + chunk < n ? begin + chunk : n;
+            partial[k] = consume_chunk(a, b, c, begin, end);
+        }
+    }
+
+    double sum = 0.0;
+    for (long long k = 0; k < nchunks; k++) sum += partial[k];
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    long long n = 100000000LL;
+    long long chunk = 1 << 16;
+    int num_threads = omp_get_max_threads();
+
+    if (argc > 1) n = atoll(argv[1]);
+    if (argc > 2) num_threads = atoi(argv[2]);
+    if (argc > 3) chunk = atoll(argv[3]);
+    omp_set_num_threads(num_threads);
+
+    long long nchunks = (n + chunk - 1) / chunk;
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *c = malloc(n * sizeof(double));
+    double *partial = malloc(nchunks * sizeof(double));
+
+    if (!a || !b || !c || !partial) {
+        fprintf(stderr, "Malloc failed\n");
+        return 1;
+    }
+
+    double t_bulk = 1e30, t_pipe = 1e30, t_noise = 1e30;
+    double sum_bulk = 0.0, sum_pipe = 0.0;
+
+    for (int rep = 0; rep < REPS; rep++) {
+        double tn;
+        double t0 = omp_get_wtime();
+        sum_bulk = bulk(a, b, c, n, chunk, partial, &tn);
+        double t1 = omp_get_wtime();
+        sum_pipe = pipelined(a, b, c, n, chunk, partial);
+        double t2 = omp_get_wtime();
+        if (t1 - t0 < t_bulk) t_bulk = t1 - t0;
+        if (t2 - t1 < t_pipe) t_pipe = t2 - t1;
+        if (tn < t_noise) t_noise = tn;
+    }
+
+    // Share of the sequential phase no longer on the critical path
+    double hidden = (t_bulk - t_pipe) / t_noise;
+    if (hidden < 0.0) hidden = 0.0;
+
+    printf("Threads,N,Chunk,add_noise_s,bulk_s,pipelined_s,speedup,hidden_serial_fraction\n");
+    printf("%d,%lld,%lld,%.6f,%.6f,%.6f,%.3f,%.3f\n",
+           num_threads, n, chunk, t_noise, t_bulk, t_pipe, t_bulk / t_pipe, hidden);
+    printf("Sum bulk      = %.15e\n", sum_bulk);
+    printf("Sum pipelined = %.15e (%s)\n", sum_pipe, sum_pipe == sum_bulk ? "identical" : "DIFFERENT");
+
+    free(a); free(b); free(c); free(partial);
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+// Runtime-sized Amdahl/Gustafson measurement driver.
+// Replaces the ex3_N* / amdahl_N* copies: N is a runtime argument, every phase
+// is timed with omp_get_wtime() (monotonic wall clock, unlike clock() which
+// sums CPU time over all threads), and one run produces:
+//   <prefix>_timing_results.csv  per-N phase times + fs (same columns as before)
+//   <prefix>_strong_scaling.csv  fixed N, threads 1..max
+//   <prefix>_weak_scaling.csv    work per thread fixed, threads 1..max
+// plus least-squares fits of the serial fraction and projected speedups.
+// Existing CSV files are never overwritten: the run stops before measuring
+// anything if one of the three is already there.
+//
+// Build: gcc -O2 -fopenmp scaling_driver.c -o scaling_driver
+// Usage: ./scaling_driver [ex3|matmul] [N1,N2,...] [max_threads] [prefix]
+//   strong scaling uses the largest N, weak scaling the smallest.
+//   prefix defaults to the workload name; it may contain a directory.
+
+#define MAX_SIZES 16
+#define MAX_PHASES 4
+#define REPS 3
+
+typedef struct {
+    const char *name;
+    int nphases;
+    const char *phase[MAX_PHASES];
+    // runs all phases on size n, fills per-phase wall times, returns checksum
+    double (*run)(long long n, double *t);
+    // size with p times the work of n (for weak scaling)
+    long long (*scale)(long long n, int p);
+} workload_t;
+
+/* ---------------- ex3 workload ---------------- */
+
+double run_ex3(long long n, double *t) {
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *c = malloc(n * sizeof(double));
+    double sum = 0.0, t0;
+
+    if (!a || !b || !c) {
+        fprintf(stderr, "Malloc failed\n");
+        exit(1);
+    }
+
+    // add_noise – strictly sequential
+    t0 = omp_get_wtime();
+    a[0] = 1.0;
+    for (long long i = 1; i < n; i++) {
+        a[i] = a[i-1] * 1.0000001;
+    }
+    t[0] = omp_get_wtime() - t0;
+
+    // init_b – parallel
+    t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        b[i] = i * 0.5;
+    }
+    t[1] = omp_get_wtime() - t0;
+
+    // compute_addition – parallel
+    t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        c[i] = a[i] + b[i];
+    }
+    t[2] = omp_get_wtime() - t0;
+
+    // reduction – parallel
+    t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (long long i = 0; i < n; i++) {
+        sum += c[i];
+    }
+    t[3] = omp_get_wtime() - t0;
+
+    free(a); free(b); free(c);
+    return sum;
+}
+
+long long scale_ex3(long long n, int p) {
+    return n * p;
+}
+
+/* ---------------- matmul workload (TP2/ex4/matmul.c) ---------------- */
+
+double run_matmul(long long n, double *t) {
+    double *A = malloc(n * n * sizeof(double));
+    double *B = malloc(n * n * sizeof(double));
+    double *C = malloc(n * n * sizeof(double));
+    double *noise = malloc(n * sizeof(double));
+    double t0;
+
+    if (!A || !B || !C || !noise) {
+        fprintf(stderr, "Malloc failed\n");
+        exit(1);
+    }
+
+    // generate_noise – strictly sequential
+    t0 = omp_get_wtime();
+    noise[0] = 1.0;
+    for (long long i = 1; i < n; i++) {
+        noise[i] = noise[i-1] * 1.0000001;
+    }
+    t[0] = omp_get_wtime() - t0;
+
+    // init_matrix – parallel
+    t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n * n; i++) {
+        A[i] = (double)(i % 100) * 0.01;
+        B[i] = (double)(i % 100) * 0.01;
+    }
+    t[1] = omp_get_wtime() - t0;
+
+    // matmul – parallel over rows, naive i-j-k kernel (see TP2/ex4/matmul.c for tuned ones)
+    t0 = omp_get_wtime();
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++) {
+        for (long long j = 0; j < n; j++) {
+            double sum = noise[i];
+            for (long long k = 0; k < n; k++) {
+                sum += A[i*n + k] * B[k*n + j];
+            }
+            C[i*n + j] = sum;
+        }
+    }
+    t[2] = omp_get_wtime() - t0;
+
+    double check = C[0];
+    free(A); free(B); free(C); free(noise);
+    return check;
+}
+
+// work ~ n^3: grow n by p^(1/3), rounded to the nearest integer
+long long scale_matmul(long long n, int p) {
+    long long m = n;
+    while ((m + 1) * (m + 1) * (m + 1) <= (long long)p * n * n * n) m++;
+    return m;
+}
+
+workload_t workloads[] = {
+    {"ex3", 4, {"add_noise", "init_b", "compute_addition", "reduction"}, run_ex3, scale_ex3},
+    {"matmul", 3, {"generate_noise", "init_matrix", "matmul"}, run_matmul, scale_matmul},
+};
+
+/* ---------------- measurement helpers ---------------- */
+
+// Best-of-REPS per phase; returns total of the best phase times
+double measure(const workload_t *w, long long n, double *best) {
+    double t[MAX_PHASES], total = 0.0;
+    for (int p = 0; p < w->nphases; p++) best[p] = 1e30;
+    for (int rep = 0; rep < REPS; rep++) {
+        w->run(n, t);
+        for (int p = 0; p < w->nphases; p++)
+            if (t[p] < best[p]) best[p] = t[p];
+    }
+    for (int p = 0; p < w->nphases; p++) total += best[p];
+    return total;
+}
+
+// Amdahl: 1/S - 1/p = fs * (1 - 1/p)
+double fit_amdahl(const int *p, const double *s, int count) {
+    double num = 0.0, den = 0.0;
+    for (int k = 0; k < count; k++) {
+        double u = 1.0 - 1.0 / p[k];
+        num += u * (1.0 / s[k] - 1.0 / p[k]);
+        den += u * u;
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
+
+// Gustafson: p - S = fs * (p - 1)
+double fit_gustafson(const int *p, const double *s, int count) {
+    double num = 0.0, den = 0.0;
+    for (int k = 0; k < count; k++) {
+        double u = p[k] - 1.0;
+        num += u * (p[k] - s[k]);
+        den += u * u;
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
+
+static const char *csv_suffixes[] = {"timing_results", "strong_scaling", "weak_scaling"};
+
+// Creates <prefix>_<suffix>.csv; "x" fails if the file already exists
+FILE *open_csv(const char *prefix, const char *suffix) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s_%s.csv", prefix, suffix);
+    FILE *f = fopen(path, "wx");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    return f;
+}
+
+int main(int argc, char *argv[]) {
+    const workload_t *w = &workloads[0];
+    long long sizes[MAX_SIZES];
+    int nsizes = 0;
+    int max_threads = omp_get_max_threads();
+
+    if (argc > 1) {
+        w = NULL;
+        for (size_t k = 0; k < sizeof(workloads) / sizeof(workloads[0]); k++)
+            if (strcmp(argv[1], workloads[k].name) == 0) w = &workloads[k];
+        if (!w) {
+            fprintf(stderr, "Usage: %s [ex3|matmul] [N1,N2,...] [max_threads] [prefix]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (argc > 2) {
+        char *list = strdup(argv[2]);
+        for (char *tok = strtok(list, ","); tok && nsizes < MAX_SIZES; tok = strtok(NULL, ","))
+            sizes[nsizes++] = atoll(tok);
+        free(list);
+    }
+    if (argc > 3) max_threads = atoi(argv[3]);
+    const char *prefix = argc > 4 ? argv[4] : w->name;
+
+    // Refuse up front rather than after minutes of measurements
+    for (size_t k = 0; k < sizeof(csv_suffixes) / sizeof(csv_suffixes[0]); k++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s_%s.csv", prefix, csv_suffixes[k]);
+        FILE *old = fopen(path, "r");
+        if (old) {
+            fclose(old);
+            fprintf(stderr, "%s already exists; remove it or give another prefix\n", path);
+            return 1;
+        }
+    }
+
+    if (nsizes == 0) {
+        if (strcmp(w->name, "ex3") == 0) {
+            sizes[0] = 5000000; sizes[1] = 10000000; sizes[2] = 100000000;
+        } else {
+            sizes[0] = 256; sizes[1] = 512; sizes[2] = 1024;
+        }
+        nsizes = 3;
+    }
+
+    long long n_min = sizes[0], n_max = sizes[0];
+    for (int k = 1; k < nsizes; k++) {
+        if (sizes[k] < n_min) n_min = sizes[k];
+        if (sizes[k] > n_max) n_max = sizes[k];
+    }
+
+    double best[MAX_PHASES];
+
+    // 1. Phase profile per N on one thread (fs = sequential phase / total)
+    omp_set_num_threads(1);
+    FILE *f = open_csv(prefix, csv_suffixes[0]);
+    fprintf(f, "N");
+    for (int p = 0; p < w->nphases; p++) fprintf(f, ",%s_s", w->phase[p]);
+    fprintf(f, ",total_time_s,sequential_fraction_fs\n");
+    for (int k = 0; k < nsizes; k++) {
+        double total = measure(w, sizes[k], best);
+        fprintf(f, "%lld", sizes[k]);
+        for (int p = 0; p < w->nphases; p++) fprintf(f, ",%.6f", best[p]);
+        fprintf(f, ",%.6f,%.6f\n", total, best[0] / total);
+        printf("N=%lld total=%.6f s fs=%.4f\n", sizes[k], total, best[0] / total);
+    }
+    fclose(f);
+
+    int threads[64], count = 0;
+    double strong[64], weak[64];
+
+    // 2. Strong scaling: fixed N = n_max
+    f = open_csv(prefix, csv_suffixes[1]);
+    fprintf(f, "Threads,N,Elapsed_Time,Speedup,Efficiency\n");
+    double t1 = 0.0;
+    for (int p = 1; p <= max_threads && count < 64; p *= 2) {
+        omp_set_num_threads(p);
+        double t = measure(w, n_max, best);
+        if (p == 1) t1 = t;
+        threads[count] = p;
+        strong[count] = t1 / t;
+        fprintf(f, "%d,%lld,%.6f,%.4f,%.2f\n", p, n_max, t, strong[count], strong[count] / p * 100.0);
+        count++;
+    }
+    fclose(f);
+
+    // 3. Weak scaling: N grows so that work per thread stays constant
+    f = open_csv(prefix, csv_suffixes[2]);
+    fprintf(f, "Threads,N,Elapsed_Time,Scaled_Speedup,Efficiency\n");
+    for (int k = 0; k < count; k++) {
+        int p = threads[k];
+        long long n = w->scale(n_min, p);
+        omp_set_num_threads(p);
+        double t = measure(w, n, best);
+        if (p == 1) t1 = t;
+        // p times the work in time t, relative to one thread on n_min
+        weak[k] = p * t1 / t;
+        fprintf(f, "%d,%lld,%.6f,%.4f,%.2f\n", p, n, t, weak[k], weak[k] / p * 100.0);
+    }
+    fclose(f);
+
+    // 4. Fits and projections
+    double fs_a = fit_amdahl(threads, strong, count);
+    double fs_g = fit_gustafson(threads, weak, count);
+    printf("Amdahl fit    fs = %.4f (strong scaling, N=%lld)\n", fs_a, n_max);
+    printf("Gustafson fit fs = %.4f (weak scaling, base N=%lld)\n", fs_g, n_min);
+    printf("Projected speedup:\n");
+    printf("Threads,Amdahl,Gustafson\n");
+    for (int p = 1; p <= 256; p *= 2) {
+        printf("%d,%.3f,%.3f\n", p, 1.0 / (fs_a + (1.0 - fs_a) / p), p - fs_g * (p - 1));
+    }
+
+    return 0;
+}
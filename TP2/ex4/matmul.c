@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+
+// Runtime-sized, OpenMP-parallel replacement for matmul_N256/512/1024.c.
+// Same phases as before (generate_noise, init_matrix, matmul, with
+// C[i][j] = noise[i] + sum_k A[i][k] * B[k][j]), but with cache-friendly kernels:
+//   naive      original i-j-k order, B walked down columns (for reference)
+//   transpose  B transposed once, then contiguous row-by-row dot products
+//   blocked    i-k-j order on BLOCK x BLOCK tiles, inner loop vectorizes
+// Build: gcc -O3 -march=native -fopenmp matmul.c -o matmul
+//   (GCC only vectorizes the blocked inner loop from -O3)
+// Usage: ./matmul <N> [threads] [naive|transpose|blocked]
+//        ./matmul weak <N0> <max_threads> [kernel]   (N = N0 * p^(1/3))
+
+#define BLOCK 64
+
+void generate_noise(double *noise, int n) {
+    noise[0] = 1.0;
+    for (int i = 1; i < n; i++) {
+        noise[i] = noise[i-1] * 1.0000001;
+    }
+}
+
+void init_matrix(double *M, int n) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)n * n; i++) {
+        M[i] = (double)(i % 100) * 0.01;
+    }
+}
+
+void matmul_naive(const double *A, const double *B, double *C, const double *noise, int n) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = noise[i];
+            for (int k = 0; k < n; k++) {
+                sum += A[(long)i*n + k] * B[(long)k*n + j];
+            }
+            C[(long)i*n + j] = sum;
+        }
+    }
+}
+
+void matmul_transpose(const double *A, const double *B, double *C, const double *noise, int n) {
+    double *BT = malloc((long)n * n * sizeof(double));
+    if (!BT) {
+        fprintf(stderr, "Malloc failed\n");
+        exit(1);
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                BT[(long)j*n + i] = B[(long)i*n + j];
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; i++) {
+            const double *a = A + (long)i*n;
+            for (int j = 0; j < n; j++) {
+                const double *b = BT + (long)j*n;
+                // 4 partial sums so the dot product is not one add chain
+                double s0 = noise[i], s1 = 0.0, s2 = 0.0, s3 = 0.0;
+                int k = 0;
+                for (; k + 4 <= n; k += 4) {
+                    s0 += a[k]     * b[k];
+                    s1 += a[k + 1] * b[k + 1];
+                    s2 += a[k + 2] * b[k + 2];
+                    s3 += a[k + 3] * b[k + 3];
+                }
+                for (; k < n; k++)
+                    s0 += a[k] * b[k];
+                C[(long)i*n + j] = (s0 + s1) + (s2 + s3);
+            }
+        }
+    }
+    free(BT);
+}
+
+void matmul_blocked(const double *A, const double *B, double *C, const double *noise, int n) {
+    // Parallel over (ii, jj) tiles of C, not just row bands, so that small N
+    // still gives every thread work; each tile of C is owned by one thread
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int ii = 0; ii < n; ii += BLOCK) {
+        for (int jj = 0; jj < n; jj += BLOCK) {
+            int i_end = ii + BLOCK < n ? ii + BLOCK : n;
+            int j_end = jj + BLOCK < n ? jj + BLOCK : n;
+            for (int i = ii; i < i_end; i++)
+                for (int j = jj; j < j_end; j++)
+                    C[(long)i*n + j] = noise[i];
+
+            for (int kk = 0; kk < n; kk += BLOCK) {
+                int k_end = kk + BLOCK < n ? kk + BLOCK : n;
+                for (int i = ii; i < i_end; i++) {
+                    double *restrict c = C + (long)i*n;
+                    for (int k = kk; k < k_end; k++) {
+                        double aik = A[(long)i*n + k];
+                        const double *restrict b = B + (long)k*n;
+                        for (int j = jj; j < j_end; j++)
+                            c[j] += aik * b[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+typedef void (*kernel_t)(const double *, const double *, double *, const double *, int);
+
+kernel_t pick_kernel(const char *name) {
+    if (strcmp(name, "naive") == 0) return matmul_naive;
+    if (strcmp(name, "transpose") == 0) return matmul_transpose;
+    if (strcmp(name, "blocked") == 0) return matmul_blocked;
+    return NULL;
+}
+
+// Runs all phases for size n; returns total wall time
+double run(int n, kernel_t kernel, double *t_noise, double *t_init, double *t_matmul, double *c0) {
+    double *A = malloc((long)n*n * sizeof(double));
+    double *B = malloc((long)n*n * sizeof(double));
+    double *C = malloc((long)n*n * sizeof(double));
+    double *noise = malloc(n * sizeof(double));
+
+    if (!A || !B || !C || !noise) {
+        fprintf(stderr, "Malloc failed\n");
+        exit(1);
+    }
+
+    double start = omp_get_wtime();
+    generate_noise(noise, n);
+    *t_noise = omp_get_wtime() - start;
+
+    start = omp_get_wtime();
+    init_matrix(A, n);
+    init_matrix(B, n);
+    *t_init = omp_get_wtime() - start;
+
+    start = omp_get_wtime();
+    kernel(A, B, C, noise, n);
+    *t_matmul = omp_get_wtime() - start;
+
+    *c0 = C[0];
+    free(A); free(B); free(C); free(noise);
+    return *t_noise + *t_init + *t_matmul;
+}
+
+int main(int argc, char *argv[]) {
+    double t_noise, t_init, t_matmul, c0;
+
+    if (argc > 1 && strcmp(argv[1], "weak") == 0) {
+        if (argc < 4) {
+            printf("Usage: %s weak <N0> <max_threads> [kernel]\n", argv[0]);
+            return 1;
+        }
+        int n0 = atoi(argv[2]);
+        int max_threads = atoi(argv[3]);
+        kernel_t kernel = pick_kernel(argc > 4 ? argv[4] : "blocked");
+        if (!kernel || n0 <= 0 || max_threads <= 0) {
+            printf("Invalid arguments.\n");
+            return 1;
+        }
+
+        double t1 = 0.0;
+        printf("Threads,N,generate_noise_s,init_matrix_s,matmul_s,total_s,Scaled_Speedup,Efficiency,GFLOPS\n");
+        for (int p = 1; p <= max_threads; p *= 2) {
+            // work ~ N^3, so N grows with the cube root of p
+            int n = n0;
+            while ((long)(n + 1) * (n + 1) * (n + 1) <= (long)p * n0 * n0 * n0) n++;
+            omp_set_num_threads(p);
+            double t = run(n, kernel, &t_noise, &t_init, &t_matmul, &c0);
+            if (p == 1) t1 = t;
+            double work = (double)n * n * n / ((double)n0 * n0 * n0);
+            double scaled = work * t1 / t;
+            printf("%d,%d,%.6f,%.6f,%.6f,%.6f,%.4f,%.2f,%.2f\n", p, n, t_noise, t_init, t_matmul,
+                   t, scaled, scaled / p * 100.0, 2.0 * n * n * n / t_matmul * 1e-9);
+        }
+        return 0;
+    }
+
+    if (argc < 2) {
+        printf("Usage: %s <N> [threads] [naive|transpose|blocked]\n", argv[0]);
+        printf("       %s weak <N0> <max_threads> [kernel]\n", argv[0]);
+        return 1;
+    }
+
+    int n = atoi(argv[1]);
+    int num_threads = argc > 2 ? atoi(argv[2]) : omp_get_max_threads();
+    kernel_t kernel = pick_kernel(argc > 3 ? argv[3] : "blocked");
+    if (!kernel || n <= 0 || num_threads <= 0) {
+        printf("Invalid arguments.\n");
+        return 1;
+    }
+    omp_set_num_threads(num_threads);
+
+    run(n, kernel, &t_noise, &t_init, &t_matmul, &c0);
+
+    printf("C[0] = %f\n", c0);
+    printf("Time generate_noise: %.6f s\n", t_noise);
+    printf("Time init_matrix: %.6f s\n", t_init);
+    printf("Time matmul: %.6f s\n", t_matmul);
+    printf("GFLOPS: %.2f\n", 2.0 * n * n * n / t_matmul * 1e-9);
+    return 0;
+}
@@ -1,6 +1,8 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h>
+#include "../placement.h"
 
 #ifndef M_SIZE
 #define M_SIZE 1000
@@ -10,16 +12,30 @@
 #define N_SIZE 1000
 #endif
 
+// Usage: ./matmul_collapse <threads> [bind] [place]
+//   bind:  none | compact | spread                (see ../placement.h)
+//   place: serial | interleave | firsttouch
+// With a policy given, the line also reports GB/s (compulsory traffic:
+// read A and B, read and write C) and GFLOPS.
+
 int main(int argc, char *argv[]) {
     int m = M_SIZE;
     int n = N_SIZE;
     int num_threads = 1;
+    bind_t bind = BIND_NONE;
+    place_t place = PLACE_SERIAL;
     
     if (argc > 1) {
         num_threads = atoi(argv[1]);
     }
+    if (argc > 2) bind = place_parse_bind(argv[2]);
+    if (argc > 3) place = place_parse(argv[3]);
     
     omp_set_num_threads(num_threads);
+
+    topology_t topo;
+    topo_read(&topo);
+    place_bind_threads(&topo, bind);
     
     // Allocate memory dynamically
     double *a = (double *)malloc(m * n * sizeof(double));
@@ -31,7 +47,11 @@ int main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
     
-    // Initialize matrices
+    // Place pages, then initialize matrices
+    place_touch(a, m, n, &topo, place);
+    place_touch(b, n, m, &topo, place);
+    place_touch(c, m, m, &topo, place);
+
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < n; j++) {
             a[i * n + j] = (i + 1) + (j + 1);
@@ -53,7 +73,7 @@ int main(int argc, char *argv[]) {
     // Matrix multiplication with timing
     double start_time = omp_get_wtime();
     
-    #pragma omp parallel for collapse(2)
+    #pragma omp parallel for collapse(2) schedule(static)
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < m; j++) {
             for (int k = 0; k < n; k++) {
@@ -65,8 +85,15 @@ int main(int argc, char *argv[]) {
     double end_time = omp_get_wtime();
     double elapsed_time = end_time - start_time;
     
-    // Output: threads,time
-    printf("%d,%.6f\n", num_threads, elapsed_time);
+    // Output: threads,time (threads,bind,place,time,GB/s,GFLOPS with a policy)
+    if (argc > 2) {
+        double bytes = 8.0 * ((double)m * n + (double)n * m + 2.0 * m * m);
+        double flops = 2.0 * m * m * n;
+        printf("%d,%s,%s,%.6f,%.3f,%.3f\n", num_threads, bind_names[bind], place_names[place],
+               elapsed_time, bytes / elapsed_time * 1e-9, flops / elapsed_time * 1e-9);
+    } else {
+        printf("%d,%.6f\n", num_threads, elapsed_time);
+    }
     
     // Free memory
     free(a);
@@ -1,7 +1,9 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <omp.h>
+#include "../placement.h"
 
 #ifndef M_SIZE
 #define M_SIZE 1000
@@ -11,126 +13,271 @@
 #define N_SIZE 1000
 #endif
 
+#define DEFAULT_TILE 32
+
+// Usage: ./matmul_scheduling <threads> <schedule> [chunk] [shape] [bind] [place]
+//   schedule: static | dynamic | guided | auto | steal
+//   chunk:    OpenMP chunk size, or tile edge for "steal" (0 = default)
+//   shape:    dense | triangular | banded
+//   bind:     none | compact | spread            (see ../placement.h)
+//   place:    serial | interleave | firsttouch   (default serial)
+// The built-in schedules all run the same kernel through schedule(runtime).
+// "steal" is a work-stealing scheduler over 2D tiles of C: every thread owns
+// a deque of tiles, pops from its bottom, and when empty steals half of a
+// random victim's remaining tiles from the top.
+// Output: threads,schedule,chunk,time,shape,bind,place,GB/s,GFLOPS,steals
+//   the same columns for every run; steals (successful steals) is 0 unless
+//   the schedule is "steal"
+
+typedef enum { SHAPE_DENSE, SHAPE_TRIANGULAR, SHAPE_BANDED } shape_t;
+static const char *shape_names[] = {"dense", "triangular", "banded"};
+#define NUM_SHAPES 3
+
+int m, n;
+shape_t shape;
+double *a, *b, *c;
+
+// k range of row i: triangular rows grow with i, banded rows keep 10% of n
+// around the diagonal, so the cost per row differs between rows
+static inline void k_range(int i, int *k_lo, int *k_hi) {
+    int diag = (int)((long)i * n / m);
+    switch (shape) {
+    case SHAPE_TRIANGULAR:
+        *k_lo = 0;
+        *k_hi = diag + 1;
+        break;
+    case SHAPE_BANDED: {
+        int half = n / 20;
+        *k_lo = diag - half < 0 ? 0 : diag - half;
+        *k_hi = diag + half + 1 > n ? n : diag + half + 1;
+        break;
+    }
+    default:
+        *k_lo = 0;
+        *k_hi = n;
+    }
+}
+
+static inline void compute_entry(int i, int j) {
+    int k_lo, k_hi;
+    k_range(i, &k_lo, &k_hi);
+    double sum = 0.0;
+    for (int k = k_lo; k < k_hi; k++) {
+        sum += a[i * n + k] * b[k * m + j];
+    }
+    c[i * m + j] = sum;
+}
+
+void matmul_runtime(void) {
+    #pragma omp parallel for collapse(2) schedule(runtime)
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            compute_entry(i, j);
+        }
+    }
+}
+
+/* ---------------- work-stealing tile scheduler ---------------- */
+
+// Tiles are never created after startup, so a deque is a range [top, bottom)
+// of tile ids guarded by its own lock. Padded to a cache line each.
+typedef struct {
+    omp_lock_t lock;
+    long top, bottom;
+    char pad[64];
+} deque_t;
+
+static inline unsigned xorshift(unsigned *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+void compute_tile(long t, int tile, int tiles_j) {
+    int i0 = (int)(t / tiles_j) * tile, j0 = (int)(t % tiles_j) * tile;
+    int i1 = i0 + tile < m ? i0 + tile : m;
+    int j1 = j0 + tile < m ? j0 + tile : m;
+    for (int i = i0; i < i1; i++)
+        for (int j = j0; j < j1; j++)
+            compute_entry(i, j);
+}
+
+long matmul_steal(int tile) {
+    int tiles_j = (m + tile - 1) / tile;
+    long ntiles = (long)tiles_j * tiles_j;
+    int nt = omp_get_max_threads();
+    deque_t *dq = malloc(nt * sizeof(deque_t));
+    long steals = 0;
+
+    for (int t = 0; t < nt; t++) {
+        omp_init_lock(&dq[t].lock);
+        dq[t].top = ntiles * t / nt;
+        dq[t].bottom = ntiles * (t + 1) / nt;
+    }
+
+    #pragma omp parallel reduction(+:steals)
+    {
+        int id = omp_get_thread_num();
+        unsigned seed = 2463534242u + 977u * id;
+
+        for (;;) {
+            // Own work first, from the bottom
+            long t = -1;
+            omp_set_lock(&dq[id].lock);
+            if (dq[id].top < dq[id].bottom) t = --dq[id].bottom;
+            omp_unset_lock(&dq[id].lock);
+            if (t >= 0) {
+                compute_tile(t, tile, tiles_j);
+                continue;
+            }
+
+            // Steal half of a victim's tiles from the top: random tries, then a sweep
+            int found = 0;
+            for (int attempt = 0; attempt < 2 * nt + nt && !found; attempt++) {
+                int v = attempt < 2 * nt ? (int)(xorshift(&seed) % nt) : attempt - 2 * nt;
+                if (v == id) continue;
+                omp_set_lock(&dq[v].lock);
+                long avail = dq[v].bottom - dq[v].top;
+                long lo = 0, hi = 0;
+                if (avail > 0) {
+                    long take = (avail + 1) / 2;
+                    lo = dq[v].top;
+                    hi = lo + take;
+                    dq[v].top = hi;
+                }
+                omp_unset_lock(&dq[v].lock);
+                if (hi > lo) {
+                    omp_set_lock(&dq[id].lock);
+                    dq[id].top = lo;
+                    dq[id].bottom = hi;
+                    omp_unset_lock(&dq[id].lock);
+                    steals++;
+                    found = 1;
+                }
+            }
+            // No tile is ever added, so empty deques everywhere means done
+            if (!found) break;
+        }
+    }
+
+    for (int t = 0; t < nt; t++) omp_destroy_lock(&dq[t].lock);
+    free(dq);
+    return steals;
+}
+
 int main(int argc, char *argv[]) {
-    int m = M_SIZE;
-    int n = N_SIZE;
+    m = M_SIZE;
+    n = N_SIZE;
     int num_threads = 1;
     char schedule_type[20] = "static";
     int chunk_size = 0;
-    
+    shape = SHAPE_DENSE;
+    bind_t bind = BIND_NONE;
+    place_t place = PLACE_SERIAL;
+
     if (argc > 1) num_threads = atoi(argv[1]);
-    if (argc > 2) strcpy(schedule_type, argv[2]);
+    if (argc > 2) {
+        strncpy(schedule_type, argv[2], sizeof(schedule_type) - 1);
+        schedule_type[sizeof(schedule_type) - 1] = '\0';
+    }
     if (argc > 3) chunk_size = atoi(argv[3]);
-    
+    if (argc > 4) {
+        int found = 0;
+        for (int k = 0; k < NUM_SHAPES; k++)
+            if (strcmp(argv[4], shape_names[k]) == 0) {
+                shape = (shape_t)k;
+                found = 1;
+            }
+        if (!found) {
+            fprintf(stderr, "Unknown shape: %s\n", argv[4]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc > 5) bind = place_parse_bind(argv[5]);
+    if (argc > 6) place = place_parse(argv[6]);
+
     omp_set_num_threads(num_threads);
-    
+
+    topology_t topo;
+    topo_read(&topo);
+    place_bind_threads(&topo, bind);
+
+    int use_steal = 0;
+    if (strcmp(schedule_type, "static") == 0) omp_set_schedule(omp_sched_static, chunk_size);
+    else if (strcmp(schedule_type, "dynamic") == 0) omp_set_schedule(omp_sched_dynamic, chunk_size);
+    else if (strcmp(schedule_type, "guided") == 0) omp_set_schedule(omp_sched_guided, chunk_size);
+    else if (strcmp(schedule_type, "auto") == 0) omp_set_schedule(omp_sched_auto, chunk_size);
+    else if (strcmp(schedule_type, "steal") == 0) use_steal = 1;
+    else {
+        fprintf(stderr, "Unknown schedule: %s\n", schedule_type);
+        exit(EXIT_FAILURE);
+    }
+
     // Allocate memory dynamically
-    double *a = (double *)malloc(m * n * sizeof(double));
-    double *b = (double *)malloc(n * m * sizeof(double));
-    double *c = (double *)malloc(m * m * sizeof(double));
-    
+    a = (double *)malloc(m * n * sizeof(double));
+    b = (double *)malloc(n * m * sizeof(double));
+    c = (double *)malloc(m * m * sizeof(double));
+
     if (!a || !b || !c) {
         fprintf(stderr, "Memory allocation failed!\n");
         exit(EXIT_FAILURE);
     }
-    
-    // Initialize matrices
+
+    // Place pages, then initialize matrices
+    place_touch(a, m, n, &topo, place);
+    place_touch(b, n, m, &topo, place);
+    place_touch(c, m, m, &topo, place);
+
     #pragma omp parallel for
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < n; j++) {
             a[i * n + j] = (i + 1) + (j + 1);
         }
     }
-    
+
     #pragma omp parallel for
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < m; j++) {
             b[i * m + j] = (i + 1) - (j + 1);
         }
     }
-    
+
     #pragma omp parallel for
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < m; j++) {
             c[i * m + j] = 0;
         }
     }
-    
-    // Matrix multiplication with different scheduling
+
+    // Matrix multiplication with the selected schedule
     double start_time = omp_get_wtime();
-    
-    if (strcmp(schedule_type, "static") == 0) {
-        if (chunk_size > 0) {
-            #pragma omp parallel for collapse(2) schedule(static, chunk_size)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        } else {
-            #pragma omp parallel for collapse(2) schedule(static)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        }
-    } else if (strcmp(schedule_type, "dynamic") == 0) {
-        if (chunk_size > 0) {
-            #pragma omp parallel for collapse(2) schedule(dynamic, chunk_size)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        } else {
-            #pragma omp parallel for collapse(2) schedule(dynamic)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        }
-    } else if (strcmp(schedule_type, "guided") == 0) {
-        if (chunk_size > 0) {
-            #pragma omp parallel for collapse(2) schedule(guided, chunk_size)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        } else {
-            #pragma omp parallel for collapse(2) schedule(guided)
-            for (int i = 0; i < m; i++) {
-                for (int j = 0; j < m; j++) {
-                    for (int k = 0; k < n; k++) {
-                        c[i * m + j] += a[i * n + k] * b[k * m + j];
-                    }
-                }
-            }
-        }
-    }
-    
+
+    long steals = 0;
+    if (use_steal)
+        steals = matmul_steal(chunk_size > 0 ? chunk_size : DEFAULT_TILE);
+    else
+        matmul_runtime();
+
     double end_time = omp_get_wtime();
     double elapsed_time = end_time - start_time;
-    
-    // Output: threads,schedule,chunk,time
-    printf("%d,%s,%d,%.6f\n", num_threads, schedule_type, chunk_size, elapsed_time);
-    
+
+    // Useful flops follow the shape; traffic is the compulsory A, B, C
+    double flops = 0.0;
+    for (int i = 0; i < m; i++) {
+        int k_lo, k_hi;
+        k_range(i, &k_lo, &k_hi);
+        flops += 2.0 * m * (k_hi - k_lo);
+    }
+    double bytes = 8.0 * ((double)m * n + (double)n * m + 2.0 * m * m);
+    printf("%d,%s,%d,%.6f,%s,%s,%s,%.3f,%.3f,%ld\n", num_threads, schedule_type, chunk_size,
+           elapsed_time, shape_names[shape], bind_names[bind], place_names[place],
+           bytes / elapsed_time * 1e-9, flops / elapsed_time * 1e-9, steals);
+
     // Free memory
     free(a);
     free(b);
     free(c);
-    
+
     return 0;
 }
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+// Distributed-memory counterpart of jacobi_optimized.c for matrices that do
+// not fit in one node. Rank r owns a contiguous block of rows of A and b and
+// the same slice of x; no rank ever holds the whole matrix.
+//
+// Rank 0 generates the system with the same srand(421) / rand() sequence as
+// jacobi_optimized.c and sends every rank its rows panel by panel, so it only
+// needs its own block plus one panel. With the same n and diagonal both
+// programs solve the same system.
+//
+// Each iteration needs the whole previous x. Two exchanges:
+//   allgather  MPI_Allgatherv of the slices into a full copy of x, then the
+//              local rows are swept against it
+//   ring       the slices travel around the ring of ranks; while the slice
+//              of step s is used for the matching column block of the local
+//              rows, the next one is already in flight (Isend / Irecv), so
+//              communication overlaps the sweep and no rank stores full x
+// The stop test is the one of jacobi_optimized.c, max|x_k - x_{k-1}| / n <=
+// DBL_EPSILON or n iterations; every check_every iterations the local max is
+// folded into a single MPI_Allreduce, so all ranks stop together. Inside a
+// rank the rows are split over OpenMP threads (OMP_NUM_THREADS).
+// Build: mpicc -O2 -march=native -fopenmp jacobi_mpi.c -o jacobi_mpi -lm
+// Usage: mpirun -np <p> ./jacobi_mpi [n] [allgather|ring] [check_every] [diag]
+//   diag defaults to n, which dominates the ~n/2 off-diagonal row sum
+// Output: procs,threads,time,iter,norm,exchange,n,GB/s,GFLOPS,residual
+
+#ifndef VAL_N
+#define VAL_N 500
+#endif
+
+#define PANEL_DOUBLES (1 << 24)   // rank 0's generation buffer, 128 MB
+#define TAG_PANEL 1
+#define TAG_RING  2
+
+typedef enum { EXCHANGE_ALLGATHER, EXCHANGE_RING } exchange_t;
+static const char *exchange_names[] = {"allgather", "ring"};
+
+typedef struct {
+    int n, rank, size;
+    int rows, first;      // local rows and global index of the first one
+    int *counts, *displs; // row blocks of every rank
+    int max_rows;
+    double *a;            // rows x n, row-major
+    double *b, *inv_diag; // local slices
+} dist_t;
+
+// Running max with NaN counted as +inf: a diverging solve gives inf - inf =
+// NaN in the add-back of the diagonal, which a plain `>` test skips. The
+// values handed to MPI_MAX are then never NaN, whose ordering MPI leaves open.
+static inline double max_nan(double m, double v) {
+    return v <= m ? m : isnan(v) ? INFINITY : v;
+}
+
+static inline double row_dot(const double *restrict a, const double *restrict x, int len) {
+    double s = 0.0;
+    #pragma omp simd reduction(+:s)
+    for (int j = 0; j < len; j++) s += a[j] * x[j];
+    return s;
+}
+
+// y = A_local x_old, with x_old distributed in slices (x_loc is ours).
+// x_full is a length-n buffer (allgather) or two max_rows buffers (ring).
+void dist_matvec(const dist_t *d, exchange_t exchange, const double *x_loc, double *x_full,
+                 double *y) {
+    int n = d->n;
+
+    if (exchange == EXCHANGE_ALLGATHER) {
+        MPI_Allgatherv(x_loc, d->rows, MPI_DOUBLE, x_full, d->counts, d->displs, MPI_DOUBLE,
+                       MPI_COMM_WORLD);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < d->rows; i++)
+            y[i] = row_dot(d->a + (size_t)i * n, x_full, n);
+        return;
+    }
+
+    // Ring: at step s we hold the slice of rank (rank - s) mod p
+    double *cur = x_full, *next = x_full + d->max_rows;
+    int left = (d->rank - 1 + d->size) % d->size, right = (d->rank + 1) % d->size;
+    int owner = d->rank;
+    memcpy(cur, x_loc, d->rows * sizeof(double));
+    for (int i = 0; i < d->rows; i++) y[i] = 0.0;
+
+    for (int s = 0; s < d->size; s++) {
+        MPI_Request req[2];
+        int last = (s == d->size - 1);
+        if (!last) {
+            MPI_Irecv(next, d->max_rows, MPI_DOUBLE, left, TAG_RING, MPI_COMM_WORLD, &req[0]);
+            MPI_Isend(cur, d->counts[owner], MPI_DOUBLE, right, TAG_RING, MPI_COMM_WORLD, &req[1]);
+        }
+
+        int col = d->displs[owner], len = d->counts[owner];
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < d->rows; i++)
+            y[i] += row_dot(d->a + (size_t)i * n + col, cur, len);
+
+        if (!last) {
+            MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+            double *tmp = cur;
+            cur = next;
+            next = tmp;
+            owner = (owner - 1 + d->size) % d->size;
+        }
+    }
+}
+
+// Jacobi iterations; returns the iteration count, the solution slice is in x
+int solve_jacobi_mpi(const dist_t *d, exchange_t exchange, int check_every, double *x,
+                     double *x_full, double *y, double *norm) {
+    int n = d->n, it = 0;
+    *norm = 0.0;
+
+    for (;;) {
+        it++;
+        int check = (it % check_every == 0) || (it >= n);
+
+        dist_matvec(d, exchange, x, x_full, y);
+
+        // y holds the full row products; add the diagonal term back
+        double local_max = 0.0;
+        #pragma omp parallel for schedule(static) reduction(max:local_max)
+        for (int i = 0; i < d->rows; i++) {
+            double aii = d->a[(size_t)i * n + d->first + i];
+            double xi = (d->b[i] - y[i] + aii * x[i]) * d->inv_diag[i];
+            local_max = max_nan(local_max, fabs(xi - x[i]));
+            x[i] = xi;
+        }
+
+        if (check) {
+            double absmax;
+            MPI_Allreduce(&local_max, &absmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            *norm = absmax / n;
+            if (*norm <= DBL_EPSILON) break;
+        }
+        if (it >= n) break;
+    }
+    return it;
+}
+
+int main(int argc, char *argv[]) {
+    int rank, size_mpi;
+    int n = VAL_N, check_every = 1;
+    double diag;
+    exchange_t exchange = EXCHANGE_ALLGATHER;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
+
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2 && strcmp(argv[2], "ring") == 0) exchange = EXCHANGE_RING;
+    if (argc > 3) check_every = atoi(argv[3]);
+    if (check_every < 1) check_every = 1;
+    diag = argc > 4 ? atof(argv[4]) : n;
+    if (n < size_mpi) {
+        if (rank == 0) printf("n must be at least the number of processes.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Row blocks: the first n % p ranks get one extra row
+    dist_t d;
+    d.n = n;
+    d.rank = rank;
+    d.size = size_mpi;
+    d.counts = malloc(size_mpi * sizeof(int));
+    d.displs = malloc(size_mpi * sizeof(int));
+    if (!d.counts || !d.displs) {
+        fprintf(stderr, "Malloc failed on rank %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int r = 0, off = 0; r < size_mpi; r++) {
+        d.counts[r] = n / size_mpi + (r < n % size_mpi);
+        d.displs[r] = off;
+        off += d.counts[r];
+    }
+    d.rows = d.counts[rank];
+    d.first = d.displs[rank];
+    d.max_rows = d.counts[0];
+
+    d.a = malloc((size_t)d.rows * n * sizeof(double));
+    d.b = malloc(d.rows * sizeof(double));
+    d.inv_diag = malloc(d.rows * sizeof(double));
+    double *x = malloc(d.rows * sizeof(double));
+    double *y = malloc(d.rows * sizeof(double));
+    double *x_full = malloc((exchange == EXCHANGE_RING ? 2 * (size_t)d.max_rows : (size_t)n)
+                            * sizeof(double));
+    if (!d.a || !d.b || !d.inv_diag || !x || !y || !x_full) {
+        fprintf(stderr, "Malloc failed on rank %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // First touch of the local rows by the threads that sweep them
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < d.rows; i++)
+        memset(d.a + (size_t)i * n, 0, n * sizeof(double));
+
+    // Rank 0 generates A in global row order and ships it in panels of whole rows
+    int panel_rows = PANEL_DOUBLES / n > 0 ? PANEL_DOUBLES / n : 1;
+    if (rank == 0) {
+        double *panel = malloc((size_t)panel_rows * n * sizeof(double));
+        double *b_all = malloc(n * sizeof(double));
+        if (!panel || !b_all) {
+            fprintf(stderr, "Malloc failed\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        srand(421);
+        for (int r = 0; r < size_mpi; r++) {
+            for (int i0 = 0; i0 < d.counts[r]; i0 += panel_rows) {
+                int rows = d.counts[r] - i0 < panel_rows ? d.counts[r] - i0 : panel_rows;
+                double *dst = r == 0 ? d.a + (size_t)i0 * n : panel;
+                for (size_t k = 0; k < (size_t)rows * n; k++)
+                    dst[k] = (double)rand() / (double)(RAND_MAX - 1);
+                if (r != 0)
+                    MPI_Send(panel, rows * n, MPI_DOUBLE, r, TAG_PANEL, MPI_COMM_WORLD);
+            }
+        }
+        for (int i = 0; i < n; i++) b_all[i] = (double)rand() / (double)(RAND_MAX - 1);
+        MPI_Scatterv(b_all, d.counts, d.displs, MPI_DOUBLE, d.b, d.rows, MPI_DOUBLE, 0,
+                     MPI_COMM_WORLD);
+        free(panel);
+        free(b_all);
+    } else {
+        for (int i0 = 0; i0 < d.rows; i0 += panel_rows) {
+            int rows = d.rows - i0 < panel_rows ? d.rows - i0 : panel_rows;
+            MPI_Recv(d.a + (size_t)i0 * n, rows * n, MPI_DOUBLE, 0, TAG_PANEL, MPI_COMM_WORLD,
+                     MPI_STATUS_IGNORE);
+        }
+        MPI_Scatterv(NULL, d.counts, d.displs, MPI_DOUBLE, d.b, d.rows, MPI_DOUBLE, 0,
+                     MPI_COMM_WORLD);
+    }
+
+    // Make matrix diagonally dominant, initialize x
+    for (int i = 0; i < d.rows; i++) {
+        d.a[(size_t)i * n + d.first + i] += diag;
+        x[i] = 1.0;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < d.rows; i++)
+        d.inv_diag[i] = 1.0 / d.a[(size_t)i * n + d.first + i];
+
+    double norme;
+    int iteration = solve_jacobi_mpi(&d, exchange, check_every, x, x_full, y, &norme);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double elapsed = MPI_Wtime() - t0;
+
+    // Relative residual max|b - A x| / max|b|, both maxima in one reduction
+    dist_matvec(&d, exchange, x, x_full, y);
+    double local[2] = {0.0, 0.0}, global[2];
+    for (int i = 0; i < d.rows; i++) {
+        local[0] = max_nan(local[0], fabs(d.b[i] - y[i]));
+        if (fabs(d.b[i]) > local[1]) local[1] = fabs(d.b[i]);
+    }
+    MPI_Reduce(local, global, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        // Per iteration: A once, plus b, x and the exchanged copy of x
+        double bytes = iteration * (8.0 * n * n + 8.0 * 3.0 * n);
+        double flops = 2.0 * iteration * (double)n * n;
+        printf("%d,%d,%.6f,%d,%.3E,%s,%d,%.3f,%.3f,%.3E\n", size_mpi, omp_get_max_threads(),
+               elapsed, iteration, norme, exchange_names[exchange], n,
+               bytes / elapsed * 1e-9, flops / elapsed * 1e-9, global[0] / global[1]);
+    }
+
+    free(d.a); free(d.b); free(d.inv_diag); free(d.counts); free(d.displs);
+    free(x); free(y); free(x_full);
+    MPI_Finalize();
+    return 0;
+}
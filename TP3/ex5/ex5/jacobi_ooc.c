@@ -0,0 +1,370 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <omp.h>
+
+// Out-of-core Jacobi for dense matrices larger than RAM. A lives in a binary
+// matrix file and is streamed once per iteration in panels of whole rows;
+// only x, b and two panels are in memory.
+//
+// A dedicated reader thread (pthread, outside the OpenMP team) preads the
+// next panel into one of NBUF page-aligned, mlock'ed buffers while the
+// OpenMP threads sweep the previous one, so the disk and the cores work at
+// the same time. The reader runs ahead across iteration boundaries; a
+// mutex / condition pair hands buffers back and forth.
+// With nrhs > 1 every panel read serves all right-hand sides, so the cost of
+// the disk pass is shared (column 0 is the file's b, the others are drawn
+// from srand(422)). The solve stops when every column meets the stop test of
+// jacobi_optimized.c, max|x_k - x_{k-1}| / n <= DBL_EPSILON, or after n
+// iterations.
+//
+// File layout, offsets multiples of ALIGN so that "direct" (O_DIRECT, which
+// bypasses the page cache and measures the device) works:
+//   [header: MAGIC, n, diag][b, padded][A row-major, padded]
+// The file is written when it does not exist, with the same srand(421) /
+// rand() sequence as jacobi_optimized.c, so with the same n and diagonal both
+// programs solve the same system. An existing file that is not a matrix file
+// or holds another n is only overwritten with the "regenerate" option, which
+// always rewrites the file (e.g. to repair a damaged one of the right n).
+// Build: gcc -O2 -march=native -fopenmp jacobi_ooc.c -o jacobi_ooc -lm
+// Usage: ./jacobi_ooc <threads> <file> [n] [nrhs] [panel_MB] [cached|direct] [check_every]
+//                     [keep|regenerate]
+//   n defaults to the file's, or VAL_N for a new file; the diagonal is n
+// Output: threads,time,iter,norm,nrhs,panel_MB,read_GB,disk_GB/s,stream_GB/s,compute_s,stall_s
+//   disk_GB/s is bytes / time spent in pread, stream_GB/s is one pass of A per
+//   iteration / wall time; with full overlap time ~ max(read, compute_s) and
+//   stall_s (sweeps waiting for data) ~ read time - compute_s.
+
+#ifndef VAL_N
+#define VAL_N 500
+#endif
+
+#define MAGIC "JACOBIA1"
+#define ALIGN 4096
+#define HEADER ALIGN
+#define NBUF 2
+#define MAX_RHS 64
+#define DEFAULT_PANEL_MB 64
+
+typedef struct {
+    int fd;
+    long n, panel_rows, npanels;
+    off_t a_offset;
+    double *buf[NBUF];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    long ready;           // panels read so far (global sequence, all iterations)
+    long consumed;        // panels swept so far
+    int stop, error;
+    double t_read;        // reader time inside pread
+    double bytes;         // bytes read
+} stream_t;
+
+static inline size_t round_up(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+static inline long panel_rows_of(const stream_t *st, long p) {
+    long rows = st->n - p * st->panel_rows;
+    return rows < st->panel_rows ? rows : st->panel_rows;
+}
+
+// Reads len bytes at off; a short read at the padded end of the file is fine
+// as long as need bytes arrived
+static int read_full(int fd, void *dst, size_t len, off_t off, size_t need) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t r = pread(fd, (char *)dst + got, len - got, off + got);
+        if (r < 0) return -1;
+        if (r == 0) break;
+        got += r;
+    }
+    return got >= need ? 0 : -1;
+}
+
+void *reader_main(void *arg) {
+    stream_t *st = arg;
+    size_t row_bytes = st->n * sizeof(double);
+
+    for (long g = 0;; g++) {
+        // Wait until the buffer of panel g has been swept (panel g - NBUF)
+        pthread_mutex_lock(&st->lock);
+        while (!st->stop && st->consumed < g - NBUF + 1)
+            pthread_cond_wait(&st->cond, &st->lock);
+        int stop = st->stop;
+        pthread_mutex_unlock(&st->lock);
+        if (stop) break;
+
+        long p = g % st->npanels;
+        size_t need = panel_rows_of(st, p) * row_bytes;
+        double t0 = omp_get_wtime();
+        int err = read_full(st->fd, st->buf[g % NBUF], round_up(need, ALIGN),
+                            st->a_offset + (off_t)(p * st->panel_rows) * row_bytes, need);
+        st->t_read += omp_get_wtime() - t0;
+        st->bytes += need;
+
+        pthread_mutex_lock(&st->lock);
+        if (err) st->error = 1;
+        st->ready = g + 1;
+        pthread_cond_broadcast(&st->cond);
+        pthread_mutex_unlock(&st->lock);
+        if (err) break;
+    }
+    return NULL;
+}
+
+// Writes the system: A with the diagonal added, then b, from one rand() stream
+int write_matrix(const char *path, long n, double diag, int overwrite) {
+    double *row = malloc(n * sizeof(double));
+    if (!row) return -1;
+    int fd = open(path, O_WRONLY | O_CREAT | (overwrite ? O_TRUNC : O_EXCL), 0644);
+    if (fd < 0) {
+        free(row);
+        return -1;
+    }
+    off_t a_offset = HEADER + round_up(n * sizeof(double), ALIGN);
+    if (ftruncate(fd, a_offset + round_up((size_t)n * n * sizeof(double), ALIGN)) != 0) {
+        free(row);
+        close(fd);
+        return -1;
+    }
+
+    char header[HEADER] = {0};
+    memcpy(header, MAGIC, 8);
+    memcpy(header + 8, &n, sizeof(long));
+    memcpy(header + 16, &diag, sizeof(double));
+    int err = pwrite(fd, header, HEADER, 0) != HEADER;
+
+    srand(421);
+    for (long i = 0; i < n && !err; i++) {
+        for (long j = 0; j < n; j++) row[j] = (double)rand() / (double)(RAND_MAX - 1);
+        row[i] += diag;
+        err = pwrite(fd, row, n * sizeof(double), a_offset + i * n * sizeof(double))
+              != (ssize_t)(n * sizeof(double));
+    }
+    for (long i = 0; i < n; i++) row[i] = (double)rand() / (double)(RAND_MAX - 1);
+    if (!err) err = pwrite(fd, row, n * sizeof(double), HEADER) != (ssize_t)(n * sizeof(double));
+    free(row);
+    close(fd);
+    return err ? -1 : 0;
+}
+
+// Sweeps rows [i0, i0 + rows) of the panel for all columns; returns the max step
+double sweep_panel(const double *panel, long i0, long rows, long n, int nrhs,
+                   const double *B, const double *X, double *X_new) {
+    double local_max = 0.0;
+    #pragma omp parallel for schedule(static) reduction(max:local_max)
+    for (long r = 0; r < rows; r++) {
+        const double *row = panel + r * n;
+        long i = i0 + r;
+        double aii = row[i];
+        double s[MAX_RHS];
+        if (nrhs == 1) {
+            double s0 = 0.0;
+            #pragma omp simd reduction(+:s0)
+            for (long j = 0; j < n; j++) s0 += row[j] * X[j];
+            s[0] = s0;
+        } else {
+            for (int c = 0; c < nrhs; c++) s[c] = 0.0;
+            for (long j = 0; j < n; j++) {
+                double aij = row[j];
+                const double *xj = X + j * nrhs;
+                #pragma omp simd
+                for (int c = 0; c < nrhs; c++) s[c] += aij * xj[c];
+            }
+        }
+        for (int c = 0; c < nrhs; c++) {
+            double xi = X[i * nrhs + c];
+            double xn = (B[i * nrhs + c] - s[c] + aii * xi) / aii;
+            if (fabs(xn - xi) > local_max) local_max = fabs(xn - xi);
+            X_new[i * nrhs + c] = xn;
+        }
+    }
+    return local_max;
+}
+
+int main(int argc, char *argv[]) {
+    int num_threads = 1, nrhs = 1, check_every = 1, direct = 0, regenerate = 0;
+    long n = 0;
+    double panel_mb = DEFAULT_PANEL_MB;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <threads> <file> [n] [nrhs] [panel_MB] [cached|direct] "
+                        "[check_every] [keep|regenerate]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    num_threads = atoi(argv[1]);
+    const char *path = argv[2];
+    if (argc > 3) n = atol(argv[3]);
+    if (argc > 4) nrhs = atoi(argv[4]);
+    if (argc > 5) panel_mb = atof(argv[5]);
+    if (argc > 6) direct = strcmp(argv[6], "direct") == 0;
+    if (argc > 7) check_every = atoi(argv[7]);
+    if (check_every < 1) check_every = 1;
+    if (argc > 8) regenerate = strcmp(argv[8], "regenerate") == 0;
+    if (nrhs < 1 || nrhs > MAX_RHS) {
+        fprintf(stderr, "nrhs must be in [1, %d]\n", MAX_RHS);
+        return EXIT_FAILURE;
+    }
+    omp_set_num_threads(num_threads);
+
+    // Existing file: take its n unless another one is asked for
+    char header[HEADER];
+    long file_n = 0;
+    int exists = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        exists = 1;
+        if (pread(fd, header, HEADER, 0) == HEADER && memcmp(header, MAGIC, 8) == 0)
+            memcpy(&file_n, header + 8, sizeof(long));
+        close(fd);
+    }
+    if (n <= 0) n = file_n > 0 ? file_n : VAL_N;
+    if (exists && n != file_n && !regenerate) {
+        if (file_n == 0)
+            fprintf(stderr, "%s exists and is not a matrix file\n", path);
+        else
+            fprintf(stderr, "%s holds n = %ld, not %ld\n", path, file_n, n);
+        fprintf(stderr, "Pass \"regenerate\" as the 8th argument to overwrite it\n");
+        return EXIT_FAILURE;
+    }
+    if (n != file_n || regenerate) {
+        double t0 = omp_get_wtime();
+        if (write_matrix(path, n, (double)n, exists) != 0) {
+            perror(path);
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "Wrote %s (n = %ld, %.3f GB) in %.2f s\n", path, n,
+                8.0 * n * n * 1e-9, omp_get_wtime() - t0);
+    }
+
+    stream_t st;
+    memset(&st, 0, sizeof(st));
+    st.fd = open(path, O_RDONLY | (direct ? O_DIRECT : 0));
+    if (st.fd < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    st.n = n;
+    st.a_offset = HEADER + round_up(n * sizeof(double), ALIGN);
+
+    // Panels of whole rows whose byte size keeps every panel offset aligned
+    long unit = ALIGN / sizeof(double);
+    for (long g = n % unit; g != 0;) {
+        long t = unit % g;
+        unit = g;
+        g = t;
+    }
+    unit = ALIGN / sizeof(double) / unit;
+    st.panel_rows = (long)(panel_mb * 1048576.0 / (n * sizeof(double)));
+    st.panel_rows = st.panel_rows < unit ? unit : st.panel_rows / unit * unit;
+    if (st.panel_rows > n) st.panel_rows = n;
+    st.npanels = (n + st.panel_rows - 1) / st.panel_rows;
+    size_t buf_bytes = round_up(st.panel_rows * n * sizeof(double), ALIGN);
+
+    // Pinned buffers; mlock may fail under RLIMIT_MEMLOCK, which only costs
+    // the guarantee that they stay resident
+    for (int k = 0; k < NBUF; k++) {
+        if (posix_memalign((void **)&st.buf[k], ALIGN, buf_bytes) != 0) {
+            fprintf(stderr, "Memory allocation failed!\n");
+            return EXIT_FAILURE;
+        }
+        memset(st.buf[k], 0, buf_bytes);
+        mlock(st.buf[k], buf_bytes);
+    }
+
+    size_t nk = (size_t)n * nrhs;
+    double *B = malloc(nk * sizeof(double));
+    double *X = malloc(nk * sizeof(double));
+    double *X_new = malloc(nk * sizeof(double));
+    double *b = NULL;
+    size_t b_bytes = round_up(n * sizeof(double), ALIGN);
+    if (!B || !X || !X_new || posix_memalign((void **)&b, ALIGN, b_bytes) != 0 ||
+        read_full(st.fd, b, b_bytes, HEADER, n * sizeof(double)) != 0) {
+        fprintf(stderr, "Cannot set up the right-hand sides\n");
+        return EXIT_FAILURE;
+    }
+    srand(422);
+    for (long i = 0; i < n; i++) {
+        for (int c = 0; c < nrhs; c++) {
+            B[i * nrhs + c] = c == 0 ? b[i] : (double)rand() / (double)(RAND_MAX - 1);
+            X[i * nrhs + c] = 1.0;
+        }
+    }
+
+    pthread_mutex_init(&st.lock, NULL);
+    pthread_cond_init(&st.cond, NULL);
+
+    double t_start = omp_get_wtime(), t_compute = 0.0, t_stall = 0.0, norme = 0.0;
+    pthread_t reader;
+    pthread_create(&reader, NULL, reader_main, &st);
+
+    int iteration = 0, error = 0;
+    for (long g = 0; !error;) {
+        iteration++;
+        int check = (iteration % check_every == 0) || (iteration >= n);
+        double step = 0.0;
+
+        for (long p = 0; p < st.npanels; p++, g++) {
+            double t0 = omp_get_wtime();
+            pthread_mutex_lock(&st.lock);
+            while (st.ready <= g && !st.error) pthread_cond_wait(&st.cond, &st.lock);
+            error = st.error;
+            pthread_mutex_unlock(&st.lock);
+            double t1 = omp_get_wtime();
+            t_stall += t1 - t0;
+            if (error) break;
+
+            double m = sweep_panel(st.buf[g % NBUF], p * st.panel_rows, panel_rows_of(&st, p),
+                                   n, nrhs, B, X, X_new);
+            if (m > step) step = m;
+            t_compute += omp_get_wtime() - t1;
+
+            pthread_mutex_lock(&st.lock);
+            st.consumed = g + 1;
+            pthread_cond_broadcast(&st.cond);
+            pthread_mutex_unlock(&st.lock);
+        }
+
+        double *tmp = X;
+        X = X_new;
+        X_new = tmp;
+        if (check) {
+            norme = step / n;
+            if (norme <= DBL_EPSILON) break;
+        }
+        if (iteration >= n) break;
+    }
+
+    pthread_mutex_lock(&st.lock);
+    st.stop = 1;
+    pthread_cond_broadcast(&st.cond);
+    pthread_mutex_unlock(&st.lock);
+    pthread_join(reader, NULL);
+    double t_total = omp_get_wtime() - t_start;
+
+    if (error) {
+        fprintf(stderr, "Read error on %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    double pass = 8.0 * n * n;
+    printf("%d,%.6f,%d,%.3E,%d,%.1f,%.3f,%.3f,%.3f,%.6f,%.6f\n", num_threads, t_total,
+           iteration, norme, nrhs, buf_bytes / 1048576.0, st.bytes * 1e-9,
+           st.bytes / st.t_read * 1e-9, pass * iteration / t_total * 1e-9, t_compute, t_stall);
+
+    for (int k = 0; k < NBUF; k++) {
+        munlock(st.buf[k], buf_bytes);
+        free(st.buf[k]);
+    }
+    pthread_mutex_destroy(&st.lock);
+    pthread_cond_destroy(&st.cond);
+    close(st.fd);
+    free(B); free(X); free(X_new); free(b);
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,14 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <float.h>
 #include <math.h>
 #include <sys/time.h>
+#include <time.h>
+#include <stdatomic.h>
 #include <omp.h>
+#include "../../placement.h"
 
 #ifndef VAL_N
 #define VAL_N 500
@@ -13,40 +17,828 @@
 #define VAL_D 100
 #endif
 
+// Usage: ./jacobi_optimized <threads> [bind] [place] [check_every] [kernel] [solver] [nrhs]
+//                           [delay_us] [system]
+//   bind:        none | compact | spread                (see ../../placement.h)
+//   place:       serial | interleave | firsttouch
+//   check_every: test convergence every k iterations (default 1)
+//   kernel:      basic | simd | simd_float                (default basic)
+//   solver:      jacobi | gs | sor | chebyshev | cg | async  (default jacobi)
+//   nrhs:        right-hand sides solved together, jacobi only (default 1)
+//   delay_us:    injected per-sweep delay for jacobi and async, thread t
+//                sleeps delay_us * t / (threads - 1)      (default 0)
+//   system:      original | spd                          (default original)
+// With a policy given, the line also reports GB/s and GFLOPS of the sweeps
+// (per iteration: read A, x, b and write x_courant; 2 n^2 flops). With a
+// solver given, it adds the solver, the final relative residual and the
+// system.
+// The system only depends on the system argument: "original" is A + VAL_D I
+// as in the exercise; "spd" is the symmetric part of A plus n I, strictly
+// diagonally dominant and SPD, so every solver converges on it (cg needs it).
+// Every solver stops on the same test, max|x_k - x_{k-1}| / n <= DBL_EPSILON
+// or n iterations, so on "spd" the rows compare time to solution. The kernel choice
+// applies to jacobi, chebyshev and the radius estimate; gs, sor, cg and
+// async use simd double rows. With nrhs > 1 the line also gets nrhs and the number of
+// column-iterations actually performed.
+// Build: gcc -O2 -march=native -fopenmp jacobi_optimized.c -o jacobi_optimized -lm
+
+#define PAD 8    // doubles per per-thread slot, one cache line
+#define MAX_RHS 64
+#define RHS_BLOCK 8   // columns per register block in the batched kernel
+#define ROWS 4   // rows per register block in the simd kernels
+
+// Running max of step or residual norms with NaN counted as +inf. On a
+// diverging system the kernels' add-back of the diagonal gives inf - inf =
+// NaN, which a plain `curr > max` test skips, so the norm would read 0 and
+// the solve would report convergence.
+static inline double max_nan(double m, double v) {
+    return v <= m ? m : isnan(v) ? INFINITY : v;
+}
+
+typedef enum { KERNEL_BASIC, KERNEL_SIMD, KERNEL_SIMD_FLOAT } kernel_t;
+static const char *kernel_names[] = {"basic", "simd", "simd_float"};
+
+// Branch-free Jacobi rows: the full row dot product includes the diagonal,
+// which is subtracted afterwards, and 1/a_ii is precomputed, so the inner
+// loop is a plain streaming dot product. ROWS rows share each load of x[j]
+// and keep one accumulator each. The matrix element type T is double or
+// float; accumulation is always in double.
+// Generates jacobi_rows_<name> (ROWS rows from i) and jacobi_row_<name> (one row).
+#define DEFINE_JACOBI_ROWS(name, T)                                           \
+static inline void jacobi_rows_##name(const T *restrict a, const double *restrict x, \
+                                      const double *restrict b,               \
+                                      const double *restrict inv_diag,        \
+                                      double *restrict x_new, int n, int i) { \
+    const T *r0 = a + (size_t)i * n, *r1 = r0 + n, *r2 = r1 + n, *r3 = r2 + n; \
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;                            \
+    _Pragma("omp simd reduction(+:s0, s1, s2, s3)")                           \
+    for (int j = 0; j < n; j++) {                                             \
+        double xj = x[j];                                                     \
+        s0 += (double)r0[j] * xj;                                             \
+        s1 += (double)r1[j] * xj;                                             \
+        s2 += (double)r2[j] * xj;                                             \
+        s3 += (double)r3[j] * xj;                                             \
+    }                                                                         \
+    x_new[i]     = (b[i]     - s0 + (double)r0[i]     * x[i])     * inv_diag[i];     \
+    x_new[i + 1] = (b[i + 1] - s1 + (double)r1[i + 1] * x[i + 1]) * inv_diag[i + 1]; \
+    x_new[i + 2] = (b[i + 2] - s2 + (double)r2[i + 2] * x[i + 2]) * inv_diag[i + 2]; \
+    x_new[i + 3] = (b[i + 3] - s3 + (double)r3[i + 3] * x[i + 3]) * inv_diag[i + 3]; \
+}                                                                             \
+                                                                              \
+static inline void jacobi_row_##name(const T *restrict a, const double *restrict x, \
+                                     const double *restrict b,                \
+                                     const double *restrict inv_diag,         \
+                                     double *restrict x_new, int n, int i) {  \
+    const T *r = a + (size_t)i * n;                                           \
+    double s = 0.0;                                                           \
+    _Pragma("omp simd reduction(+:s)")                                        \
+    for (int j = 0; j < n; j++)                                               \
+        s += (double)r[j] * x[j];                                             \
+    x_new[i] = (b[i] - s + (double)r[i] * x[i]) * inv_diag[i];                \
+}
+
+DEFINE_JACOBI_ROWS(double, double)
+DEFINE_JACOBI_ROWS(float, float)
+
+typedef enum { SYSTEM_ORIGINAL, SYSTEM_SPD } system_kind_t;
+static const char *system_names[] = {"original", "spd"};
+
+typedef enum { SOLVER_JACOBI, SOLVER_GS, SOLVER_SOR, SOLVER_CHEBYSHEV, SOLVER_CG,
+               SOLVER_ASYNC } solver_t;
+static const char *solver_names[] = {"jacobi", "gs", "sor", "chebyshev", "cg", "async"};
+#define NUM_SOLVERS 6
+
+#define RHO_SWEEPS 30      // power iterations for the Jacobi spectral radius
+#define RHO_MARGIN 1.02    // Chebyshev diverges if the radius is underestimated
+#define SOR_WARMUP 6       // Gauss-Seidel sweeps measured to pick omega
+
+// Dense system shared by the solvers
+typedef struct {
+    int n;
+    const double *a, *b, *inv_diag;
+    const float *af;       // float copy of a for the simd_float kernel
+    kernel_t kernel;
+    double *partial;       // 2 * threads * PAD reduction slots
+    int delay_us;          // injected sleep per sweep, see inject_delay
+} system_t;
+
+// Simulated heterogeneous node: after each sweep thread t sleeps
+// delay_us * t / (threads - 1), so thread 0 runs free and the last thread
+// is the slowest. Used by jacobi and async.
+static inline void inject_delay(const system_t *s) {
+    int nt = omp_get_num_threads();
+    if (s->delay_us <= 0 || nt < 2) return;
+    long ns = 1000L * s->delay_us * omp_get_thread_num() / (nt - 1);
+    struct timespec ts = {ns / 1000000000L, ns % 1000000000L};
+    nanosleep(&ts, NULL);
+}
+
 void random_number(double* array, int size) {
     for (int i = 0; i < size; i++) {
         array[i] = (double)rand() / (double)(RAND_MAX - 1);
     }
 }
 
+// Jacobi update of row block blk: x_new = D^-1 (b - (A - D) x_old)
+static inline void jacobi_block(const system_t *s, const double *b, const double *x_old,
+                                double *x_new, int blk) {
+    int n = s->n;
+    int i0 = blk * ROWS;
+    int i1 = i0 + ROWS < n ? i0 + ROWS : n;
+    if (s->kernel == KERNEL_BASIC) {
+        for (int i = i0; i < i1; i++) {
+            double sum = 0.0;
+            for (int j = 0; j < n; j++) {
+                if (j != i) {
+                    sum += s->a[i * n + j] * x_old[j];
+                }
+            }
+            x_new[i] = (b[i] - sum) / s->a[i * n + i];
+        }
+    } else if (i1 - i0 == ROWS) {
+        if (s->kernel == KERNEL_SIMD)
+            jacobi_rows_double(s->a, x_old, b, s->inv_diag, x_new, n, i0);
+        else
+            jacobi_rows_float(s->af, x_old, b, s->inv_diag, x_new, n, i0);
+    } else {
+        for (int i = i0; i < i1; i++) {
+            if (s->kernel == KERNEL_SIMD)
+                jacobi_row_double(s->a, x_old, b, s->inv_diag, x_new, n, i);
+            else
+                jacobi_row_float(s->af, x_old, b, s->inv_diag, x_new, n, i);
+        }
+    }
+}
+
+// End of an iteration inside a solver's parallel region: publishes this
+// thread's max step at a check, waits on the iteration's single barrier and
+// returns 1 when the solve is over. Every thread reduces the slots itself, so
+// all take the same exit. Slots are double-buffered by check parity so a fast
+// thread never overwrites one still being read.
+static inline int iteration_end(const system_t *s, int it, int check, int *checks,
+                                double local_max, double *norm) {
+    int id = omp_get_thread_num();
+    int nt = omp_get_num_threads();
+    double *slots = s->partial + (*checks & 1) * nt * PAD;
+    if (check) slots[id * PAD] = local_max;
+
+    #pragma omp barrier
+
+    if (check) {
+        double absmax = 0.0;
+        for (int t = 0; t < nt; t++)
+            absmax = max_nan(absmax, slots[t * PAD]);
+        (*checks)++;
+        *norm = absmax / s->n;
+        if (*norm <= DBL_EPSILON) return 1;
+    }
+    return it >= s->n;
+}
+
+// Plain Jacobi. One parallel region for the whole solve; each iteration reads
+// x_old and writes x_new, then a single barrier and a private pointer swap.
+// The max-norm is fused into the update and only computed every check_every
+// iterations. Returns the iteration count; the solution ends up in x.
+int solve_jacobi(const system_t *s, int check_every, double *x, double *x_tmp, double *norm) {
+    int n = s->n, iteration = 0;
+    int nblk = (n + ROWS - 1) / ROWS;
+
+    #pragma omp parallel
+    {
+        double *x_old = x, *x_new = x_tmp;
+        double last_norm = 0.0;
+        int it = 0, checks = 0;
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= n);
+            double local_max = 0.0;
+
+            #pragma omp for schedule(static) nowait
+            for (int blk = 0; blk < nblk; blk++) {
+                jacobi_block(s, s->b, x_old, x_new, blk);
+                if (check) {
+                    for (int i = blk * ROWS; i < n && i < (blk + 1) * ROWS; i++)
+                        local_max = max_nan(local_max, fabs(x_old[i] - x_new[i]));
+                }
+            }
+
+            inject_delay(s);
+            int done = iteration_end(s, it, check, &checks, local_max, &last_norm);
+            double *tmp = x_old;
+            x_old = x_new;
+            x_new = tmp;
+            if (done) break;
+        }
+
+        if (x_old != x) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) x[i] = x_old[i];
+        }
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+        }
+    }
+    return iteration;
+}
+
+// Asynchronous (chaotic) relaxation. Each thread sweeps its own contiguous
+// rows in place, using whatever values of the other blocks are currently
+// visible; there is no barrier, a flush after each sweep publishes the
+// thread's rows. Shared x is only accessed through relaxed atomic reads and
+// writes (plain moves on x86), so the staleness is intended but there is no
+// data race: each sweep starts from a private snapshot of x, which keeps the
+// row dot products vectorized, and stores its new rows back atomically.
+// Convergence is lock-free: every check_every sweeps a thread stores in its
+// padded flag whether its last sweep met the common stop test. A thread
+// that sees all flags set elects itself checker with a compare-exchange
+// and evaluates the stop test on a snapshot of the live x, max |r_i / a_ii| / n
+// (the step Jacobi would take), and raises the done flag if it holds. The
+// cap is n sweeps that changed something, for every thread with rows:
+// threads past it keep sweeping, and the last one to reach it raises the
+// flag. Returns the most sweeps done by a thread.
+typedef struct {
+    atomic_int converged;
+    char pad[64 - sizeof(atomic_int)];
+} async_flag_t;
+
+int solve_async(const system_t *s, int check_every, double *x, double *norm) {
+    int n = s->n, max_sweeps = 0;
+    double max_norm = 0.0;
+    atomic_int done = 0, checking = 0, capped = 0;
+    async_flag_t *flags = calloc(omp_get_max_threads(), sizeof(async_flag_t));
+    int failed = 0;
+
+    #pragma omp parallel reduction(max:max_sweeps, max_norm)
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        int lo = (int)((long)n * id / nt), hi = (int)((long)n * (id + 1) / nt);
+        int sweeps = 0, progress = 0;
+        double last_norm = 0.0;
+        double *xs = malloc(n * sizeof(double));
+        if (!xs) {
+            #pragma omp atomic write
+            failed = 1;
+            atomic_store_explicit(&done, 1, memory_order_release);
+        }
+        // A thread without rows (n < threads) never makes progress, so it
+        // counts as capped from the start
+        if (lo == hi && atomic_fetch_add(&capped, 1) == nt - 1)
+            atomic_store_explicit(&done, 1, memory_order_release);
+
+        while (!atomic_load_explicit(&done, memory_order_acquire)) {
+            double local_max = 0.0;
+            for (int j = 0; j < n; j++) {
+                #pragma omp atomic read
+                xs[j] = x[j];
+            }
+            for (int i = lo; i < hi; i++) {
+                const double *r = s->a + (size_t)i * n;
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = 0; j < n; j++) sum += r[j] * xs[j];
+                double xi = (s->b[i] - sum + r[i] * xs[i]) * s->inv_diag[i];
+                local_max = max_nan(local_max, fabs(xi - xs[i]));
+                xs[i] = xi;
+                #pragma omp atomic write
+                x[i] = xi;
+            }
+            sweeps++;
+            #pragma omp flush
+            inject_delay(s);
+
+            // Nothing moved: the inputs from the other blocks are stale, so
+            // give the core to a thread that has work (oversubscribed nodes)
+            // and do not count the sweep towards the cap. A non-finite step
+            // (divergence) is infinite here, so it counts.
+            if (local_max / n <= DBL_EPSILON) sched_yield();
+            else progress++;
+
+            if (progress == n && atomic_fetch_add(&capped, 1) == nt - 1) {
+                atomic_store_explicit(&done, 1, memory_order_release);
+                break;
+            }
+            if (sweeps % check_every) continue;
+
+            last_norm = local_max / n;
+            atomic_store_explicit(&flags[id].converged, last_norm <= DBL_EPSILON,
+                                  memory_order_release);
+            int all = 1;
+            for (int t = 0; t < nt && all; t++)
+                all = atomic_load_explicit(&flags[t].converged, memory_order_acquire);
+            int idle = 0;
+            if (all && atomic_compare_exchange_strong(&checking, &idle, 1)) {
+                double worst = 0.0;
+                for (int j = 0; j < n; j++) {
+                    #pragma omp atomic read
+                    xs[j] = x[j];
+                }
+                for (int i = 0; i < n; i++) {
+                    const double *r = s->a + (size_t)i * n;
+                    double sum = 0.0;
+                    #pragma omp simd reduction(+:sum)
+                    for (int j = 0; j < n; j++) sum += r[j] * xs[j];
+                    double step = fabs((s->b[i] - sum) * s->inv_diag[i]);
+                    worst = max_nan(worst, step);
+                }
+                if (worst / n <= DBL_EPSILON)
+                    atomic_store_explicit(&done, 1, memory_order_release);
+                atomic_store(&checking, 0);
+            }
+        }
+        max_sweeps = sweeps;
+        max_norm = last_norm;
+        free(xs);
+    }
+    free(flags);
+    if (failed) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    *norm = max_norm;
+    return max_sweeps;
+}
+
+// Block Gauss-Seidel / SOR. Each thread owns a contiguous block of rows and
+// sweeps it in order: entries inside its block already updated this
+// iteration are used (x_new), everything else comes from x_old. With one
+// thread this is exact Gauss-Seidel; with p threads the blocks are coupled
+// Jacobi-style, which is the usual multithreaded variant for dense matrices.
+// The row dot product is split into three branch-free simd segments.
+// With omega <= 0, omega is estimated: SOR_WARMUP Gauss-Seidel sweeps give
+// the observed contraction lambda of the step, then omega = 2 / (1 + sqrt(1 -
+// lambda)) (Young's formula with lambda = rho_J^2), and if the next
+// SOR_WARMUP sweeps contract no faster than lambda, omega goes back to 1.
+// Young's formula assumes a consistently ordered matrix, which these dense
+// ones are not: on them the estimate overshoots and sor ends up a few sweeps
+// behind gs. It is kept as the textbook baseline, not as an acceleration.
+int solve_sor(const system_t *s, double omega, int check_every, double *x, double *x_tmp,
+              double *norm, double *omega_used) {
+    int n = s->n, iteration = 0;
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        int lo = (int)((long)n * id / nt), hi = (int)((long)n * (id + 1) / nt);
+        double *x_old = x, *x_new = x_tmp;
+        double last_norm = 0.0, prev_norm = 0.0, w = omega > 0.0 ? omega : 1.0;
+        double lambda = 1.0, switch_norm = 0.0;
+        int it = 0, checks = 0;
+
+        for (;;) {
+            it++;
+            int warmup = omega <= 0.0 && it <= 2 * SOR_WARMUP;
+            int check = warmup || (it % check_every == 0) || (it >= n);
+            double local_max = 0.0;
+
+            for (int i = lo; i < hi; i++) {
+                const double *r = s->a + (size_t)i * n;
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = 0; j < lo; j++) sum += r[j] * x_old[j];
+                #pragma omp simd reduction(+:sum)
+                for (int j = lo; j < i; j++) sum += r[j] * x_new[j];
+                #pragma omp simd reduction(+:sum)
+                for (int j = i + 1; j < n; j++) sum += r[j] * x_old[j];
+                double gs = (s->b[i] - sum) * s->inv_diag[i];
+                double xi = x_old[i] + w * (gs - x_old[i]);
+                x_new[i] = xi;
+                if (check) local_max = max_nan(local_max, fabs(x_old[i] - xi));
+            }
+
+            prev_norm = last_norm;
+            int done = iteration_end(s, it, check, &checks, local_max, &last_norm);
+            double *tmp = x_old;
+            x_old = x_new;
+            x_new = tmp;
+            if (done) break;
+
+            // Same norms on every thread, so every thread picks the same omega
+            if (warmup && it == SOR_WARMUP) {
+                lambda = last_norm / prev_norm;
+                if (lambda < 1.0) w = 2.0 / (1.0 + sqrt(1.0 - lambda));
+                switch_norm = last_norm;
+            } else if (warmup && it == 2 * SOR_WARMUP) {
+                if (pow(last_norm / switch_norm, 1.0 / SOR_WARMUP) >= lambda) w = 1.0;
+            }
+        }
+
+        if (x_old != x) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) x[i] = x_old[i];
+        }
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+            *omega_used = w;
+        }
+    }
+    return iteration;
+}
+
+// Chebyshev semi-iteration on top of Jacobi for a spectrum of the Jacobi
+// iteration matrix in [-rho, rho]:
+//   x_{k+1} = w_{k+1} (J(x_k) - x_{k-1}) + x_{k-1}
+//   w_1 = 1, w_2 = 1 / (1 - rho^2 / 2), w_{k+1} = 1 / (1 - rho^2 w_k / 4)
+// x_prev is only read element-wise, so the new iterate overwrites it in place
+// and the buffers rotate by pointer swap; x_jac holds the Jacobi update.
+int solve_chebyshev(const system_t *s, double rho, int check_every, double *x, double *x_tmp,
+                    double *x_jac, double *norm) {
+    int n = s->n, iteration = 0;
+    int nblk = (n + ROWS - 1) / ROWS;
+    double rho2 = rho * rho;
+
+    #pragma omp parallel
+    {
+        double *x_old = x, *x_prev = x_tmp;
+        double last_norm = 0.0, omega = 1.0;
+        int it = 0, checks = 0;
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; i++) x_prev[i] = x_old[i];
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= n);
+            double local_max = 0.0;
+            if (it == 2) omega = 1.0 / (1.0 - rho2 / 2.0);
+            else if (it > 2) omega = 1.0 / (1.0 - rho2 * omega / 4.0);
+
+            #pragma omp for schedule(static) nowait
+            for (int blk = 0; blk < nblk; blk++) {
+                jacobi_block(s, s->b, x_old, x_jac, blk);
+                for (int i = blk * ROWS; i < n && i < (blk + 1) * ROWS; i++) {
+                    double xi = omega * (x_jac[i] - x_prev[i]) + x_prev[i];
+                    x_prev[i] = xi;
+                    if (check) local_max = max_nan(local_max, fabs(x_old[i] - xi));
+                }
+            }
+
+            int done = iteration_end(s, it, check, &checks, local_max, &last_norm);
+            double *tmp = x_old;
+            x_old = x_prev;
+            x_prev = tmp;
+            if (done) break;
+        }
+
+        if (x_old != x) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) x[i] = x_old[i];
+        }
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+        }
+    }
+    return iteration;
+}
+
+// Conjugate gradient, for symmetric positive definite A. Same persistent
+// region; the two dot products per iteration use the two halves of the slot
+// array, and three barriers separate every write of a half from its reads.
+// The step max |alpha p_i| rides along with r.r for the common stop test.
+int solve_cg(const system_t *s, int check_every, double *x, double *r, double *p, double *q,
+             double *norm) {
+    int n = s->n, iteration = 0;
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        double *slots_pq = s->partial, *slots_rr = s->partial + nt * PAD;
+        double last_norm = 0.0, rr = 0.0, local = 0.0;
+        int it = 0;
+
+        // r = b - A x, p = r
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) {
+            const double *row = s->a + (size_t)i * n;
+            double sum = 0.0;
+            #pragma omp simd reduction(+:sum)
+            for (int j = 0; j < n; j++) sum += row[j] * x[j];
+            r[i] = s->b[i] - sum;
+            p[i] = r[i];
+            local += r[i] * r[i];
+        }
+        slots_rr[id * PAD] = local;
+        #pragma omp barrier
+        for (int t = 0; t < nt; t++) rr += slots_rr[t * PAD];
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= n);
+
+            // q = A p, p.q
+            local = 0.0;
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < n; i++) {
+                const double *row = s->a + (size_t)i * n;
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = 0; j < n; j++) sum += row[j] * p[j];
+                q[i] = sum;
+                local += p[i] * sum;
+            }
+            slots_pq[id * PAD] = local;
+            #pragma omp barrier
+            double pq = 0.0;
+            for (int t = 0; t < nt; t++) pq += slots_pq[t * PAD];
+            double alpha = rr / pq;
+
+            // x += alpha p, r -= alpha q, r.r and max step
+            double local_rr = 0.0, local_max = 0.0;
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < n; i++) {
+                double step = alpha * p[i];
+                x[i] += step;
+                r[i] -= alpha * q[i];
+                local_rr += r[i] * r[i];
+                local_max = max_nan(local_max, fabs(step));
+            }
+            slots_rr[id * PAD] = local_rr;
+            slots_rr[id * PAD + 1] = local_max;
+            #pragma omp barrier
+            double rr_new = 0.0, absmax = 0.0;
+            for (int t = 0; t < nt; t++) {
+                rr_new += slots_rr[t * PAD];
+                absmax = max_nan(absmax, slots_rr[t * PAD + 1]);
+            }
+            if (check) {
+                last_norm = absmax / n;
+                if (last_norm <= DBL_EPSILON || rr_new == 0.0) break;
+            }
+            if (it >= n) break;
+
+            // p = r + beta p; the barrier makes p complete for the next A p
+            double beta = rr_new / rr;
+            rr = rr_new;
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) p[i] = r[i] + beta * p[i];
+        }
+
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+        }
+    }
+    return iteration;
+}
+
+// Spectral radius of the Jacobi iteration matrix G = I - D^-1 A by power
+// iteration. G v is a Jacobi sweep with b = 0, so the same kernels are used.
+double estimate_jacobi_radius(const system_t *s, double *v, double *w, const double *zero) {
+    int n = s->n;
+    int nblk = (n + ROWS - 1) / ROWS;
+    double rho = 0.0;
+
+    for (int i = 0; i < n; i++) v[i] = 1.0 / sqrt((double)n);
+    for (int k = 0; k < RHO_SWEEPS; k++) {
+        double nw = 0.0;
+        #pragma omp parallel for schedule(static)
+        for (int blk = 0; blk < nblk; blk++)
+            jacobi_block(s, zero, v, w, blk);
+        #pragma omp parallel for reduction(+:nw)
+        for (int i = 0; i < n; i++) nw += w[i] * w[i];
+        rho = sqrt(nw);
+        if (rho == 0.0) break;
+        #pragma omp parallel for
+        for (int i = 0; i < n; i++) v[i] = w[i] / rho;
+    }
+    return rho;
+}
+
+// Jacobi on k right-hand sides at once. Iterates are n x k, row-major, so
+// each a_ij is loaded once per sweep and multiplies a contiguous run of
+// columns: a GEMM-like sweep instead of k GEMVs. The work arrays use a row
+// stride kw rounded up to RHS_BLOCK, and the kernel keeps a ROWS x RHS_BLOCK
+// block of accumulators in registers (rows past n are clamped to row n-1 and
+// discarded). Columns are checked separately; a converged column is saved
+// to X and the last active column is moved into its slot, so the live
+// columns stay a prefix and later sweeps only cover ceil(kact / RHS_BLOCK)
+// blocks. Retirement is serial (O(n) per column) inside a single.
+// Returns the number of sweeps; iters[c], norms[c] are per original column.
+int solve_jacobi_batched(const system_t *s, int k, int check_every, double *X, const double *B,
+                         double *W0, double *W1, double *Bw, int *iters, double *norms) {
+    int n = s->n, sweeps = 0, kact = k;
+    int kw = (k + RHS_BLOCK - 1) / RHS_BLOCK * RHS_BLOCK;
+    int nblk = (n + ROWS - 1) / ROWS;
+    int col_id[MAX_RHS];
+    double *slots = calloc((size_t)omp_get_max_threads() * kw, sizeof(double));
+    for (int c = 0; c < k; c++) col_id[c] = c;
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        double *x_old = W0, *x_new = W1;
+        int it = 0;
+
+        // Padding columns stay zero: b = 0 and x = 0
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; i++) {
+            for (int c = 0; c < kw; c++) {
+                W0[(size_t)i * kw + c] = c < k ? X[(size_t)i * k + c] : 0.0;
+                W1[(size_t)i * kw + c] = 0.0;
+                Bw[(size_t)i * kw + c] = c < k ? B[(size_t)i * k + c] : 0.0;
+            }
+        }
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= n);
+            int ka = kact;    // only changes inside the single below
+            int kb = (ka + RHS_BLOCK - 1) / RHS_BLOCK * RHS_BLOCK;
+            double local_max[MAX_RHS];
+            for (int c = 0; c < ka; c++) local_max[c] = 0.0;
+
+            #pragma omp for schedule(static) nowait
+            for (int blk = 0; blk < nblk; blk++) {
+                int i0 = blk * ROWS;
+                const double *r[ROWS];
+                for (int q = 0; q < ROWS; q++)
+                    r[q] = s->a + (size_t)(i0 + q < n ? i0 + q : n - 1) * n;
+
+                for (int c0 = 0; c0 < kb; c0 += RHS_BLOCK) {
+                    double acc[ROWS][RHS_BLOCK] = {{0.0}};
+                    for (int j = 0; j < n; j++) {
+                        const double *xj = x_old + (size_t)j * kw + c0;
+                        double a0 = r[0][j], a1 = r[1][j], a2 = r[2][j], a3 = r[3][j];
+                        #pragma omp simd
+                        for (int c = 0; c < RHS_BLOCK; c++) {
+                            acc[0][c] += a0 * xj[c];
+                            acc[1][c] += a1 * xj[c];
+                            acc[2][c] += a2 * xj[c];
+                            acc[3][c] += a3 * xj[c];
+                        }
+                    }
+                    for (int q = 0; q < ROWS && i0 + q < n; q++) {
+                        int i = i0 + q;
+                        const double *xi = x_old + (size_t)i * kw + c0;
+                        const double *bi = Bw + (size_t)i * kw + c0;
+                        double *xn = x_new + (size_t)i * kw + c0;
+                        double aii = r[q][i], inv = s->inv_diag[i];
+                        for (int c = 0; c < RHS_BLOCK; c++) {
+                            xn[c] = (bi[c] - acc[q][c] + aii * xi[c]) * inv;
+                            if (check && c0 + c < ka)
+                                local_max[c0 + c] = max_nan(local_max[c0 + c],
+                                                            fabs(xn[c] - xi[c]));
+                        }
+                    }
+                }
+            }
+
+            if (check)
+                for (int c = 0; c < ka; c++) slots[id * kw + c] = local_max[c];
+
+            #pragma omp barrier
+
+            double *tmp = x_old;
+            x_old = x_new;
+            x_new = tmp;
+
+            // Slots are only read here and the single ends with a barrier,
+            // so one buffer is enough
+            #pragma omp single
+            {
+                sweeps = it;
+                for (int c = check ? kact - 1 : -1; c >= 0; c--) {
+                    double absmax = 0.0;
+                    for (int t = 0; t < nt; t++)
+                        absmax = max_nan(absmax, slots[t * kw + c]);
+                    norms[col_id[c]] = absmax / n;
+                    if (absmax / n > DBL_EPSILON && it < n) continue;
+
+                    iters[col_id[c]] = it;
+                    int last = kact - 1;
+                    for (int i = 0; i < n; i++) {
+                        X[(size_t)i * k + col_id[c]] = x_old[(size_t)i * kw + c];
+                        x_old[(size_t)i * kw + c] = x_old[(size_t)i * kw + last];
+                        Bw[(size_t)i * kw + c] = Bw[(size_t)i * kw + last];
+                    }
+                    col_id[c] = col_id[last];
+                    kact--;
+                }
+            }
+            if (kact == 0) break;
+        }
+    }
+    free(slots);
+    return sweeps;
+}
+
 int main(int argc, char *argv[]) {
     int n = VAL_N, diag = VAL_D;
-    int i, j, iteration = 0;
-    double norme;
+    int i, iteration = 0;
+    double norme = 0.0;
     int num_threads = 1;
+    int check_every = 1, nrhs = 1, delay_us = 0;
+    kernel_t kernel = KERNEL_BASIC;
+    solver_t solver = SOLVER_JACOBI;
+    system_kind_t system = SYSTEM_ORIGINAL;
+    bind_t bind = BIND_NONE;
+    place_t place = PLACE_SERIAL;
 
     if (argc > 1) {
         num_threads = atoi(argv[1]);
     }
+    if (argc > 2) bind = place_parse_bind(argv[2]);
+    if (argc > 3) place = place_parse(argv[3]);
+    if (argc > 4) check_every = atoi(argv[4]);
+    if (check_every < 1) check_every = 1;
+    if (argc > 5) {
+        if (strcmp(argv[5], "simd") == 0) kernel = KERNEL_SIMD;
+        else if (strcmp(argv[5], "simd_float") == 0) kernel = KERNEL_SIMD_FLOAT;
+    }
+    if (argc > 6) {
+        for (int k = 0; k < NUM_SOLVERS; k++)
+            if (strcmp(argv[6], solver_names[k]) == 0) solver = (solver_t)k;
+    }
+    if (argc > 7) nrhs = atoi(argv[7]);
+    if (argc > 8) delay_us = atoi(argv[8]);
+    if (argc > 9) {
+        if (strcmp(argv[9], "spd") == 0) system = SYSTEM_SPD;
+        else if (strcmp(argv[9], "original") != 0) {
+            fprintf(stderr, "Unknown system: %s\n", argv[9]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (solver == SOLVER_CG && system != SYSTEM_SPD) {
+        fprintf(stderr, "cg needs a symmetric positive definite matrix: use the spd system\n");
+        exit(EXIT_FAILURE);
+    }
+    if (nrhs < 1 || nrhs > MAX_RHS || (nrhs > 1 && solver != SOLVER_JACOBI)) {
+        fprintf(stderr, "nrhs must be in [1, %d], and > 1 only with the jacobi solver\n", MAX_RHS);
+        exit(EXIT_FAILURE);
+    }
     
     omp_set_num_threads(num_threads);
 
+    topology_t topo;
+    topo_read(&topo);
+    place_bind_threads(&topo, bind);
+
     double *a = (double*)malloc(n * n * sizeof(double));
     double *x = (double*)malloc(n * sizeof(double));
     double *x_courant = (double*)malloc(n * sizeof(double));
     double *b = (double*)malloc(n * sizeof(double));
+    double *partial = (double*)calloc(2 * num_threads * PAD, sizeof(double));
+    double *inv_diag = (double*)malloc(n * sizeof(double));
+    double *work1 = (double*)malloc(n * sizeof(double));
+    double *work2 = (double*)calloc(n, sizeof(double));
+    size_t nk = (size_t)n * nrhs;
+    size_t nkw = (size_t)n * ((nrhs + RHS_BLOCK - 1) / RHS_BLOCK * RHS_BLOCK);
+    double *X = NULL, *B = NULL, *W0 = NULL, *W1 = NULL, *Bw = NULL;
+    int col_iters[MAX_RHS];
+    double col_norms[MAX_RHS];
+    if (nrhs > 1) {
+        X = (double*)malloc(nk * sizeof(double));
+        B = (double*)malloc(nk * sizeof(double));
+        W0 = (double*)malloc(nkw * sizeof(double));
+        W1 = (double*)malloc(nkw * sizeof(double));
+        Bw = (double*)malloc(nkw * sizeof(double));
+        if (!X || !B || !W0 || !W1 || !Bw) {
+            fprintf(stderr, "Memory allocation failed!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    float *af = NULL;
+    if (kernel == KERNEL_SIMD_FLOAT) af = (float*)malloc((size_t)n * n * sizeof(float));
 
-    if (!a || !x || !x_courant || !b) {
+    if (!a || !x || !x_courant || !b || !partial || !inv_diag || !work1 || !work2 ||
+        (kernel == KERNEL_SIMD_FLOAT && !af)) {
         fprintf(stderr, "Memory allocation failed!\n");
         exit(EXIT_FAILURE);
     }
 
     double t_cpu_0, t_cpu_1, t_cpu;
 
+    // Place pages before the (serial, seeded) initialization writes values
+    place_touch(a, n, n, &topo, place);
+    place_touch(x, n, 1, &topo, place);
+    place_touch(x_courant, n, 1, &topo, place);
+    place_touch(b, n, 1, &topo, place);
+
     srand(421);
     random_number(a, n * n);
     random_number(b, n);
 
+    // spd: the symmetric part (A + A^T) / 2 with diagonal n. Its off-diagonal
+    // row sums are ~n/2 < n, so it is strictly diagonally dominant, hence SPD
+    // and convergent for the Jacobi-based solvers as well as CG.
+    if (system == SYSTEM_SPD) {
+        diag = n;
+        for (i = 0; i < n; i++)
+            for (int j = i + 1; j < n; j++)
+                a[i * n + j] = a[j * n + i] = 0.5 * (a[i * n + j] + a[j * n + i]);
+    }
+
     // Make matrix diagonally dominant
     for (i = 0; i < n; i++) {
         a[i * n + i] += diag;
@@ -57,47 +849,132 @@ int main(int argc, char *argv[]) {
         x[i] = 1.0;
     }
 
-    t_cpu_0 = omp_get_wtime();
-
-    while (1) {
-        iteration++;
-
-        // Parallelized Jacobi iteration
-        #pragma omp parallel for private(j) schedule(static)
+    // Batched right-hand sides: column 0 is b, the others continue the sequence
+    if (nrhs > 1) {
         for (i = 0; i < n; i++) {
-            double sum = 0.0;
-            for (j = 0; j < n; j++) {
-                if (j != i) {
-                    sum += a[i * n + j] * x[j];
-                }
+            for (int c = 0; c < nrhs; c++) {
+                B[(size_t)i * nrhs + c] = c == 0 ? b[i] : (double)rand() / (double)(RAND_MAX - 1);
+                X[(size_t)i * nrhs + c] = 1.0;
             }
-            x_courant[i] = (b[i] - sum) / a[i * n + i];
         }
+    }
 
-        // Calculate convergence criterion
-        double absmax = 0.0;
-        #pragma omp parallel for reduction(max:absmax)
-        for (i = 0; i < n; i++) {
-            double curr = fabs(x[i] - x_courant[i]);
-            if (curr > absmax)
-                absmax = curr;
-        }
-        norme = absmax / n;
+    // Float copy of the matrix, first-touched by the rows' static owners
+    if (af) {
+        #pragma omp parallel for schedule(static)
+        for (i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                af[(size_t)i * n + j] = (float)a[i * n + j];
+    }
 
-        if ((norme <= DBL_EPSILON) || (iteration >= n)) break;
+    system_t sys = {n, a, b, inv_diag, af, kernel, partial, delay_us};
+    int sweeps = 0;
 
-        // Copy new values
-        #pragma omp parallel for
-        for (i = 0; i < n; i++) {
-            x[i] = x_courant[i];
+    t_cpu_0 = omp_get_wtime();
+
+    // Inverse diagonal, once per solve
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < n; i++) {
+        inv_diag[i] = 1.0 / a[i * n + i];
+    }
+
+    // Chebyshev needs the Jacobi radius; the estimate is part of the time to solution
+    double rho = 0.0, omega = 1.0;
+    if (solver == SOLVER_CHEBYSHEV) {
+        rho = estimate_jacobi_radius(&sys, x_courant, work1, work2) * RHO_MARGIN;
+        sweeps += RHO_SWEEPS;
+        if (rho >= 1.0) {
+            fprintf(stderr, "Jacobi radius %.3f >= 1, no Chebyshev acceleration\n", rho);
+            rho = 0.0;
         }
     }
 
+    long col_total = 0;
+    if (nrhs > 1) {
+        iteration = solve_jacobi_batched(&sys, nrhs, check_every, X, B, W0, W1, Bw,
+                                         col_iters, col_norms);
+        norme = 0.0;
+        for (int c = 0; c < nrhs; c++) {
+            col_total += col_iters[c];
+            norme = max_nan(norme, col_norms[c]);
+        }
+    } else switch (solver) {
+    case SOLVER_JACOBI:
+        iteration = solve_jacobi(&sys, check_every, x, x_courant, &norme);
+        break;
+    case SOLVER_GS:
+        iteration = solve_sor(&sys, 1.0, check_every, x, x_courant, &norme, &omega);
+        break;
+    case SOLVER_SOR:
+        iteration = solve_sor(&sys, 0.0, check_every, x, x_courant, &norme, &omega);
+        break;
+    case SOLVER_CHEBYSHEV:
+        iteration = solve_chebyshev(&sys, rho, check_every, x, x_courant, work1, &norme);
+        break;
+    case SOLVER_CG:
+        iteration = solve_cg(&sys, check_every, x, x_courant, work1, work2, &norme);
+        break;
+    case SOLVER_ASYNC:
+        iteration = solve_async(&sys, check_every, x, &norme);
+        break;
+    }
+    sweeps += iteration;
+
     t_cpu_1 = omp_get_wtime();
     t_cpu = t_cpu_1 - t_cpu_0;
 
-    printf("%d,%.6f,%d,%.3E\n", num_threads, t_cpu, iteration, norme);
+    if (nrhs > 1) {
+        // Worst relative residual over the columns
+        double worst = 0.0;
+        for (int c = 0; c < nrhs; c++) {
+            double rmax = 0.0, bmax = 0.0;
+            #pragma omp parallel for reduction(max:rmax, bmax)
+            for (i = 0; i < n; i++) {
+                double sum = 0.0;
+                for (int j = 0; j < n; j++) sum += a[i * n + j] * X[(size_t)j * nrhs + c];
+                double bi = B[(size_t)i * nrhs + c];
+                rmax = max_nan(rmax, fabs(bi - sum));
+                if (fabs(bi) > bmax) bmax = fabs(bi);
+            }
+            worst = max_nan(worst, rmax / bmax);
+        }
+        // The matrix is streamed once per sweep whatever the number of columns
+        double bytes = 8.0 * iteration * (double)n * n + 8.0 * 3.0 * n * col_total;
+        double flops = 2.0 * (double)n * n * col_total;
+        printf("%d,%.6f,%d,%.3E,%s,%s,%.3f,%.3f,%s,%s,%.3E,%s,%d,%ld\n", num_threads, t_cpu,
+               iteration, norme, bind_names[bind], place_names[place], bytes / t_cpu * 1e-9,
+               flops / t_cpu * 1e-9, kernel_names[kernel], solver_names[solver], worst,
+               system_names[system], nrhs, col_total);
+    } else if (argc > 6) {
+        // Relative residual max|b - A x| / max|b| of the returned solution
+        double rmax = 0.0, bmax = 0.0;
+        #pragma omp parallel for reduction(max:rmax, bmax)
+        for (i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (int j = 0; j < n; j++) sum += a[i * n + j] * x[j];
+            rmax = max_nan(rmax, fabs(b[i] - sum));
+            if (fabs(b[i]) > bmax) bmax = fabs(b[i]);
+        }
+        double elem = kernel == KERNEL_SIMD_FLOAT ? 4.0 : 8.0;
+        double bytes = sweeps * (elem * n * n + 8.0 * 3.0 * n);
+        double flops = 2.0 * sweeps * (double)n * n;
+        printf("%d,%.6f,%d,%.3E,%s,%s,%.3f,%.3f,%s,%s,%.3E,%s\n", num_threads, t_cpu, iteration,
+               norme, bind_names[bind], place_names[place], bytes / t_cpu * 1e-9,
+               flops / t_cpu * 1e-9, kernel_names[kernel], solver_names[solver], rmax / bmax,
+               system_names[system]);
+    } else if (argc > 2) {
+        double elem = kernel == KERNEL_SIMD_FLOAT ? 4.0 : 8.0;
+        double bytes = iteration * (elem * n * n + 8.0 * 3.0 * n);
+        double flops = 2.0 * iteration * (double)n * n;
+        printf("%d,%.6f,%d,%.3E,%s,%s,%.3f,%.3f,%s\n", num_threads, t_cpu, iteration, norme,
+               bind_names[bind], place_names[place], bytes / t_cpu * 1e-9, flops / t_cpu * 1e-9,
+               kernel_names[kernel]);
+    } else {
+        printf("%d,%.6f,%d,%.3E\n", num_threads, t_cpu, iteration, norme);
+    }
 
-    free(a); free(x); free(x_courant); free(b);
+    free(a); free(x); free(x_courant); free(b); free(partial);
+    free(inv_diag); free(af); free(work1); free(work2);
+    free(X); free(B); free(W0); free(W1); free(Bw);
     return EXIT_SUCCESS;
 }
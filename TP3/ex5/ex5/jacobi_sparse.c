@@ -0,0 +1,668 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+
+// Sparse counterpart of jacobi_optimized.c: the same Jacobi and CG iterations
+// on a matrix stored in CSR or SELL-C-sigma, so n can reach millions.
+//
+// SELL-C-sigma (sliced ELLPACK): rows are sorted by length inside windows of
+// SELL_SIGMA rows, then cut into chunks of SELL_C rows. A chunk is stored
+// column-major and padded to its longest row, so the inner loop runs over
+// SELL_C consecutive rows with unit stride and vectorizes; sorting keeps the
+// padding small.
+//
+// The matrix is either read from a Matrix Market file (coordinate, real /
+// integer / pattern, general / symmetric) or generated: a random symmetric
+// stencil with about nnz_per_row entries per row (fewer near the borders), offsets
+// drawn once and values hashed from (row, offset), with a diagonal of
+// DOMINANCE times the off-diagonal row sum. Generation is parallel, so every
+// row is first-touched by the thread that later iterates on it.
+//
+// Stop test as in jacobi_optimized.c: max|x_k - x_{k-1}| / n <= DBL_EPSILON,
+// checked every check_every iterations, or MAX_ITER iterations.
+// Build: gcc -O2 -march=native -fopenmp jacobi_sparse.c -o jacobi_sparse -lm
+// Usage: ./jacobi_sparse <threads> [n | file.mtx] [nnz_per_row] [csr|sell] [jacobi|cg] [check_every]
+// Output: threads,time,iterations,norm,format,solver,n,nnz,GB/s,GFLOPS,residual
+
+#ifndef SELL_C
+#define SELL_C 8
+#endif
+#ifndef SELL_SIGMA
+#define SELL_SIGMA 256
+#endif
+
+#define DOMINANCE 2.0
+#define MAX_ITER 1000
+#define SEED 421
+#define PAD 8    // doubles per per-thread slot, one cache line
+
+typedef enum { FORMAT_CSR, FORMAT_SELL } format_t;
+typedef enum { SOLVER_JACOBI, SOLVER_CG } solver_t;
+static const char *format_names[] = {"csr", "sell"};
+static const char *solver_names[] = {"jacobi", "cg"};
+
+typedef struct {
+    int n;
+    long nnz;
+    long *row_ptr;
+    int *col;
+    double *val;
+} csr_t;
+
+typedef struct {
+    int n, nchunks;
+    long stored;          // entries including padding
+    long *chunk_ptr;      // first entry of each chunk
+    int *width;           // padded row length of each chunk
+    int *perm;            // perm[k] = original row at sorted position k
+    int *col;
+    double *val;
+} sell_t;
+
+// Matrix and vectors shared by the solvers
+typedef struct {
+    format_t format;
+    csr_t csr;
+    sell_t sell;
+    double *diag, *inv_diag, *b;
+    double *partial;      // 2 * threads * PAD reduction slots
+} system_t;
+
+static void *xmalloc(size_t bytes) {
+    void *p = malloc(bytes);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Running max with NaN counted as +inf, so that a diverging solve (inf - inf
+// in the add-back of the diagonal) never passes the stop test
+static inline double max_nan(double m, double v) {
+    return v <= m ? m : isnan(v) ? INFINITY : v;
+}
+
+static inline uint64_t splitmix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline double hash_unit(uint64_t key) {
+    return (splitmix64(key) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int compare_int(const void *p, const void *q) {
+    return *(const int *)p - *(const int *)q;
+}
+
+/* ---------------- generator and loader ---------------- */
+
+void csr_random(csr_t *m, int n, int nnz_row) {
+    int h = (nnz_row - 1) / 2;
+    if (h < 1) h = 1;
+    if (h > n - 1) h = n - 1;
+
+    // h distinct offsets in [1, band], sorted; a band of n/16 keeps most
+    // offsets valid on both sides of the diagonal while x accesses stay scattered
+    int band = n / 16 > h ? n / 16 : h;
+    if (band > n - 1) band = n - 1;
+    int *off = xmalloc(h * sizeof(int));
+    uint64_t draw = 0;
+    for (int k = 0; k < h; k++) {
+        int d, dup;
+        do {
+            d = 1 + (int)(splitmix64(SEED + draw++) % (uint64_t)band);
+            dup = 0;
+            for (int q = 0; q < k; q++) dup |= (off[q] == d);
+        } while (dup);
+        off[k] = d;
+    }
+    qsort(off, h, sizeof(int), compare_int);
+
+    m->n = n;
+    m->row_ptr = xmalloc((n + 1) * sizeof(long));
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        int len = 1;
+        for (int k = 0; k < h; k++) len += (i - off[k] >= 0) + (i + off[k] < n);
+        m->row_ptr[i + 1] = len;
+    }
+    m->row_ptr[0] = 0;
+    for (int i = 0; i < n; i++) m->row_ptr[i + 1] += m->row_ptr[i];
+    m->nnz = m->row_ptr[n];
+    m->col = xmalloc(m->nnz * sizeof(int));
+    m->val = xmalloc(m->nnz * sizeof(double));
+
+    // Columns in increasing order; a_ij = a_ji since the value only depends
+    // on the lower index of the pair and the offset
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        long p = m->row_ptr[i], pdiag;
+        double sum = 0.0;
+        for (int k = h - 1; k >= 0; k--) {
+            int j = i - off[k];
+            if (j < 0) continue;
+            double v = -(0.1 + 0.9 * hash_unit(((uint64_t)j * h + k) ^ ((uint64_t)SEED << 40)));
+            m->col[p] = j;
+            m->val[p++] = v;
+            sum += fabs(v);
+        }
+        pdiag = p++;
+        for (int k = 0; k < h; k++) {
+            int j = i + off[k];
+            if (j >= n) break;
+            double v = -(0.1 + 0.9 * hash_unit(((uint64_t)i * h + k) ^ ((uint64_t)SEED << 40)));
+            m->col[p] = j;
+            m->val[p++] = v;
+            sum += fabs(v);
+        }
+        m->col[pdiag] = i;
+        m->val[pdiag] = DOMINANCE * sum + (sum == 0.0 ? 1.0 : 0.0);
+    }
+    free(off);
+}
+
+// Returns 0 on success; *symmetric tells whether the file declared symmetry
+int csr_load_mm(csr_t *m, const char *path, int *symmetric) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    char line[1024], object[64], format[64], field[64], symmetry[64];
+    if (!fgets(line, sizeof(line), f) ||
+        sscanf(line, "%%%%MatrixMarket %63s %63s %63s %63s", object, format, field, symmetry) != 4 ||
+        strcmp(object, "matrix") != 0 || strcmp(format, "coordinate") != 0 ||
+        strcmp(field, "complex") == 0 ||
+        (strcmp(symmetry, "general") != 0 && strcmp(symmetry, "symmetric") != 0)) {
+        fprintf(stderr, "%s: only coordinate real/integer/pattern general/symmetric matrices\n", path);
+        fclose(f);
+        return -1;
+    }
+    int pattern = strcmp(field, "pattern") == 0;
+    *symmetric = strcmp(symmetry, "symmetric") == 0;
+
+    do {
+        if (!fgets(line, sizeof(line), f)) {
+            fclose(f);
+            return -1;
+        }
+    } while (line[0] == '%');
+
+    int rows, cols;
+    long entries;
+    if (sscanf(line, "%d %d %ld", &rows, &cols, &entries) != 3 || rows != cols || rows < 1 ||
+        entries < 0) {
+        fprintf(stderr, "%s: bad size line, the matrix must be square and non-empty\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    // Read as COO (mirrored when symmetric), then counting sort into CSR
+    long cap = *symmetric ? 2 * entries : entries, count = 0;
+    int *ci = malloc(cap * sizeof(int)), *cj = malloc(cap * sizeof(int));
+    double *cv = malloc(cap * sizeof(double));
+    if (!ci || !cj || !cv) {
+        fprintf(stderr, "%s: cannot allocate %ld entries\n", path, cap);
+        free(ci); free(cj); free(cv);
+        fclose(f);
+        return -1;
+    }
+    for (long e = 0; e < entries; e++) {
+        int i, j;
+        double v = 1.0;
+        if (!fgets(line, sizeof(line), f) ||
+            (pattern ? sscanf(line, "%d %d", &i, &j) != 2
+                     : sscanf(line, "%d %d %lf", &i, &j, &v) != 3) ||
+            i < 1 || i > rows || j < 1 || j > cols) {
+            fprintf(stderr, "%s: bad or missing entry %ld\n", path, e);
+            free(ci); free(cj); free(cv);
+            fclose(f);
+            return -1;
+        }
+        ci[count] = i - 1; cj[count] = j - 1; cv[count++] = v;
+        if (*symmetric && i != j) {
+            ci[count] = j - 1; cj[count] = i - 1; cv[count++] = v;
+        }
+    }
+    fclose(f);
+
+    m->n = rows;
+    m->nnz = count;
+    m->row_ptr = calloc(rows + 1, sizeof(long));
+    m->col = malloc(count * sizeof(int));
+    m->val = malloc(count * sizeof(double));
+    long *fill = malloc(rows * sizeof(long));
+    if (!m->row_ptr || !m->col || !m->val || !fill) {
+        fprintf(stderr, "%s: cannot allocate the CSR arrays\n", path);
+        free(m->row_ptr); free(m->col); free(m->val);
+        free(fill); free(ci); free(cj); free(cv);
+        return -1;
+    }
+    for (long e = 0; e < count; e++) m->row_ptr[ci[e] + 1]++;
+    for (int i = 0; i < rows; i++) m->row_ptr[i + 1] += m->row_ptr[i];
+    memcpy(fill, m->row_ptr, rows * sizeof(long));
+    for (long e = 0; e < count; e++) {
+        long p = fill[ci[e]]++;
+        m->col[p] = cj[e];
+        m->val[p] = cv[e];
+    }
+    free(fill); free(ci); free(cj); free(cv);
+    return 0;
+}
+
+/* ---------------- SELL-C-sigma ---------------- */
+
+typedef struct { int len, row; } row_len_t;
+
+static int compare_len_desc(const void *p, const void *q) {
+    const row_len_t *a = p, *b = q;
+    if (a->len != b->len) return b->len - a->len;
+    return a->row - b->row;
+}
+
+void sell_from_csr(sell_t *s, const csr_t *m) {
+    int n = m->n;
+    s->n = n;
+    s->nchunks = (n + SELL_C - 1) / SELL_C;
+    s->perm = xmalloc(n * sizeof(int));
+    s->width = xmalloc(s->nchunks * sizeof(int));
+    s->chunk_ptr = xmalloc((s->nchunks + 1) * sizeof(long));
+
+    // Sort rows by decreasing length inside each sigma window
+    int nwin = (n + SELL_SIGMA - 1) / SELL_SIGMA;
+    #pragma omp parallel for schedule(static)
+    for (int w = 0; w < nwin; w++) {
+        row_len_t buf[SELL_SIGMA];
+        int r0 = w * SELL_SIGMA;
+        int r1 = r0 + SELL_SIGMA < n ? r0 + SELL_SIGMA : n;
+        for (int r = r0; r < r1; r++) {
+            buf[r - r0].len = (int)(m->row_ptr[r + 1] - m->row_ptr[r]);
+            buf[r - r0].row = r;
+        }
+        qsort(buf, r1 - r0, sizeof(row_len_t), compare_len_desc);
+        for (int r = r0; r < r1; r++) s->perm[r] = buf[r - r0].row;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < s->nchunks; c++) {
+        int w = 0;
+        for (int r = 0; r < SELL_C && c * SELL_C + r < n; r++) {
+            int i = s->perm[c * SELL_C + r];
+            int len = (int)(m->row_ptr[i + 1] - m->row_ptr[i]);
+            if (len > w) w = len;
+        }
+        s->width[c] = w;
+    }
+    s->chunk_ptr[0] = 0;
+    for (int c = 0; c < s->nchunks; c++)
+        s->chunk_ptr[c + 1] = s->chunk_ptr[c] + (long)s->width[c] * SELL_C;
+    s->stored = s->chunk_ptr[s->nchunks];
+    s->col = xmalloc(s->stored * sizeof(int));
+    s->val = xmalloc(s->stored * sizeof(double));
+
+    // Column-major inside a chunk; padding points at column 0 with value 0
+    #pragma omp parallel for schedule(static)
+    for (int c = 0; c < s->nchunks; c++) {
+        long base = s->chunk_ptr[c];
+        for (int r = 0; r < SELL_C; r++) {
+            int k = c * SELL_C + r;
+            long p0 = 0, len = 0;
+            if (k < n) {
+                p0 = m->row_ptr[s->perm[k]];
+                len = m->row_ptr[s->perm[k] + 1] - p0;
+            }
+            for (int j = 0; j < s->width[c]; j++) {
+                long q = base + (long)j * SELL_C + r;
+                s->col[q] = j < len ? m->col[p0 + j] : 0;
+                s->val[q] = j < len ? m->val[p0 + j] : 0.0;
+            }
+        }
+    }
+}
+
+/* ---------------- kernels ---------------- */
+// Orphaned `omp for ... nowait`: called inside a solver's parallel region,
+// each thread handles its static share of rows (CSR) or chunks (SELL).
+
+// x_new = D^-1 (b - (A - D) x_old); returns this thread's max |x_new - x_old|
+static double csr_jacobi(const system_t *s, const double *x_old, double *x_new) {
+    const csr_t *m = &s->csr;
+    double local_max = 0.0;
+    #pragma omp for schedule(static) nowait
+    for (int i = 0; i < m->n; i++) {
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (long p = m->row_ptr[i]; p < m->row_ptr[i + 1]; p++)
+            sum += m->val[p] * x_old[m->col[p]];
+        double xi = (s->b[i] - sum + s->diag[i] * x_old[i]) * s->inv_diag[i];
+        x_new[i] = xi;
+        local_max = max_nan(local_max, fabs(xi - x_old[i]));
+    }
+    return local_max;
+}
+
+static double sell_jacobi(const system_t *s, const double *x_old, double *x_new) {
+    const sell_t *m = &s->sell;
+    double local_max = 0.0;
+    #pragma omp for schedule(static) nowait
+    for (int c = 0; c < m->nchunks; c++) {
+        double y[SELL_C] = {0.0};
+        const int *col = m->col + m->chunk_ptr[c];
+        const double *val = m->val + m->chunk_ptr[c];
+        for (int j = 0; j < m->width[c]; j++) {
+            #pragma omp simd
+            for (int r = 0; r < SELL_C; r++)
+                y[r] += val[j * SELL_C + r] * x_old[col[j * SELL_C + r]];
+        }
+        for (int r = 0; r < SELL_C && c * SELL_C + r < m->n; r++) {
+            int i = m->perm[c * SELL_C + r];
+            double xi = (s->b[i] - y[r] + s->diag[i] * x_old[i]) * s->inv_diag[i];
+            x_new[i] = xi;
+            local_max = max_nan(local_max, fabs(xi - x_old[i]));
+        }
+    }
+    return local_max;
+}
+
+// q = A p; returns this thread's part of p.q
+static double csr_spmv_dot(const system_t *s, const double *p, double *q) {
+    const csr_t *m = &s->csr;
+    double local = 0.0;
+    #pragma omp for schedule(static) nowait
+    for (int i = 0; i < m->n; i++) {
+        double sum = 0.0;
+        #pragma omp simd reduction(+:sum)
+        for (long k = m->row_ptr[i]; k < m->row_ptr[i + 1]; k++)
+            sum += m->val[k] * p[m->col[k]];
+        q[i] = sum;
+        local += p[i] * sum;
+    }
+    return local;
+}
+
+static double sell_spmv_dot(const system_t *s, const double *p, double *q) {
+    const sell_t *m = &s->sell;
+    double local = 0.0;
+    #pragma omp for schedule(static) nowait
+    for (int c = 0; c < m->nchunks; c++) {
+        double y[SELL_C] = {0.0};
+        const int *col = m->col + m->chunk_ptr[c];
+        const double *val = m->val + m->chunk_ptr[c];
+        for (int j = 0; j < m->width[c]; j++) {
+            #pragma omp simd
+            for (int r = 0; r < SELL_C; r++)
+                y[r] += val[j * SELL_C + r] * p[col[j * SELL_C + r]];
+        }
+        for (int r = 0; r < SELL_C && c * SELL_C + r < m->n; r++) {
+            int i = m->perm[c * SELL_C + r];
+            q[i] = y[r];
+            local += p[i] * y[r];
+        }
+    }
+    return local;
+}
+
+static inline double spmv_dot(const system_t *s, const double *p, double *q) {
+    return s->format == FORMAT_CSR ? csr_spmv_dot(s, p, q) : sell_spmv_dot(s, p, q);
+}
+
+/* ---------------- solvers ---------------- */
+
+// End of an iteration: publishes this thread's max step at a check, waits on
+// the iteration's barrier and returns 1 when the solve is over. Slots
+// alternate per check so a fast thread never overwrites one being read.
+static inline int iteration_end(const system_t *s, int n, int it, int check, int *checks,
+                                double local_max, double *norm) {
+    int id = omp_get_thread_num();
+    int nt = omp_get_num_threads();
+    double *slots = s->partial + (*checks & 1) * nt * PAD;
+    if (check) slots[id * PAD] = local_max;
+
+    #pragma omp barrier
+
+    if (check) {
+        double absmax = 0.0;
+        for (int t = 0; t < nt; t++)
+            absmax = max_nan(absmax, slots[t * PAD]);
+        (*checks)++;
+        *norm = absmax / n;
+        if (*norm <= DBL_EPSILON) return 1;
+    }
+    return it >= MAX_ITER;
+}
+
+int solve_jacobi(const system_t *s, int n, int check_every, double *x, double *x_tmp,
+                 double *norm) {
+    int iteration = 0;
+
+    #pragma omp parallel
+    {
+        double *x_old = x, *x_new = x_tmp;
+        double last_norm = 0.0;
+        int it = 0, checks = 0;
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= MAX_ITER);
+            double local_max = s->format == FORMAT_CSR ? csr_jacobi(s, x_old, x_new)
+                                                       : sell_jacobi(s, x_old, x_new);
+            int done = iteration_end(s, n, it, check, &checks, local_max, &last_norm);
+            double *tmp = x_old;
+            x_old = x_new;
+            x_new = tmp;
+            if (done) break;
+        }
+
+        if (x_old != x) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) x[i] = x_old[i];
+        }
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+        }
+    }
+    return iteration;
+}
+
+// Conjugate gradient (A must be SPD), same structure as in jacobi_optimized.c
+int solve_cg(const system_t *s, int n, int check_every, double *x, double *r, double *p,
+             double *q, double *norm) {
+    int iteration = 0;
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        double *slots_pq = s->partial, *slots_rr = s->partial + nt * PAD;
+        double last_norm = 0.0, rr = 0.0, local = 0.0;
+        int it = 0;
+
+        // r = b - A x, p = r
+        spmv_dot(s, x, q);
+        #pragma omp barrier
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) {
+            r[i] = s->b[i] - q[i];
+            p[i] = r[i];
+            local += r[i] * r[i];
+        }
+        slots_rr[id * PAD] = local;
+        #pragma omp barrier
+        for (int t = 0; t < nt; t++) rr += slots_rr[t * PAD];
+
+        for (;;) {
+            it++;
+            int check = (it % check_every == 0) || (it >= MAX_ITER);
+
+            slots_pq[id * PAD] = spmv_dot(s, p, q);
+            #pragma omp barrier
+            double pq = 0.0;
+            for (int t = 0; t < nt; t++) pq += slots_pq[t * PAD];
+            double alpha = rr / pq;
+
+            double local_rr = 0.0, local_max = 0.0;
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < n; i++) {
+                double step = alpha * p[i];
+                x[i] += step;
+                r[i] -= alpha * q[i];
+                local_rr += r[i] * r[i];
+                local_max = max_nan(local_max, fabs(step));
+            }
+            slots_rr[id * PAD] = local_rr;
+            slots_rr[id * PAD + 1] = local_max;
+            #pragma omp barrier
+            double rr_new = 0.0, absmax = 0.0;
+            for (int t = 0; t < nt; t++) {
+                rr_new += slots_rr[t * PAD];
+                absmax = max_nan(absmax, slots_rr[t * PAD + 1]);
+            }
+            if (check) {
+                last_norm = absmax / n;
+                if (last_norm <= DBL_EPSILON || rr_new == 0.0) break;
+            }
+            if (it >= MAX_ITER) break;
+
+            double beta = rr_new / rr;
+            rr = rr_new;
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) p[i] = r[i] + beta * p[i];
+        }
+
+        #pragma omp master
+        {
+            iteration = it;
+            *norm = last_norm;
+        }
+    }
+    return iteration;
+}
+
+int main(int argc, char *argv[]) {
+    int num_threads = 1, n = 1000000, nnz_row = 15, check_every = 1;
+    const char *source = NULL;
+    format_t format = FORMAT_CSR;
+    solver_t solver = SOLVER_JACOBI;
+
+    if (argc > 1) num_threads = atoi(argv[1]);
+    if (argc > 2) {
+        if (strstr(argv[2], ".mtx")) source = argv[2];
+        else n = atoi(argv[2]);
+    }
+    if (argc > 3) nnz_row = atoi(argv[3]);
+    if (argc > 4 && strcmp(argv[4], "sell") == 0) format = FORMAT_SELL;
+    if (argc > 5 && strcmp(argv[5], "cg") == 0) solver = SOLVER_CG;
+    if (argc > 6) check_every = atoi(argv[6]);
+    if (check_every < 1) check_every = 1;
+    if (!source && (n < 2 || nnz_row < 1)) {
+        fprintf(stderr, "Need n >= 2 and nnz_per_row >= 1\n");
+        exit(EXIT_FAILURE);
+    }
+
+    omp_set_num_threads(num_threads);
+
+    system_t sys;
+    memset(&sys, 0, sizeof(sys));
+    sys.format = format;
+    int symmetric = 1;
+    if (source) {
+        if (csr_load_mm(&sys.csr, source, &symmetric) != 0) exit(EXIT_FAILURE);
+        n = sys.csr.n;
+    } else {
+        csr_random(&sys.csr, n, nnz_row);
+    }
+    if (solver == SOLVER_CG && !symmetric)
+        fprintf(stderr, "Warning: %s is not declared symmetric, CG may not converge\n", source);
+
+    sys.diag = malloc(n * sizeof(double));
+    sys.inv_diag = malloc(n * sizeof(double));
+    sys.b = malloc(n * sizeof(double));
+    sys.partial = calloc(2 * num_threads * PAD, sizeof(double));
+    double *x = malloc(n * sizeof(double));
+    double *w1 = malloc(n * sizeof(double));
+    double *w2 = malloc(n * sizeof(double));
+    double *w3 = malloc(n * sizeof(double));
+    if (!sys.diag || !sys.inv_diag || !sys.b || !sys.partial || !x || !w1 || !w2 || !w3) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Vectors first-touched with the solvers' static row split
+    int missing = 0;
+    #pragma omp parallel for schedule(static) reduction(+:missing)
+    for (int i = 0; i < n; i++) {
+        double d = 0.0;
+        for (long p = sys.csr.row_ptr[i]; p < sys.csr.row_ptr[i + 1]; p++)
+            if (sys.csr.col[p] == i) d += sys.csr.val[p];
+        sys.diag[i] = d;
+        sys.inv_diag[i] = d != 0.0 ? 1.0 / d : 0.0;
+        missing += (d == 0.0);
+        sys.b[i] = hash_unit((uint64_t)i ^ 0x5DEECE66DULL);
+        x[i] = 1.0;
+        w1[i] = w2[i] = w3[i] = 0.0;
+    }
+    if (missing) {
+        fprintf(stderr, "%d rows have a zero diagonal, Jacobi is undefined\n", missing);
+        exit(EXIT_FAILURE);
+    }
+
+    long stored = sys.csr.nnz;
+    if (format == FORMAT_SELL) {
+        sell_from_csr(&sys.sell, &sys.csr);
+        stored = sys.sell.stored;
+        fprintf(stderr, "SELL-%d-%d: %ld stored for %ld nonzeros (beta = %.3f)\n", SELL_C,
+                SELL_SIGMA, stored, sys.csr.nnz, (double)sys.csr.nnz / stored);
+    }
+
+    double norme = 0.0;
+    int iteration;
+    double t0 = omp_get_wtime();
+    if (solver == SOLVER_JACOBI)
+        iteration = solve_jacobi(&sys, n, check_every, x, w1, &norme);
+    else
+        iteration = solve_cg(&sys, n, check_every, x, w1, w2, w3, &norme);
+    double t_cpu = omp_get_wtime() - t0;
+
+    // Relative residual max|b - A x| / max|b|
+    double rmax = 0.0, bmax = 0.0;
+    #pragma omp parallel
+    {
+        spmv_dot(&sys, x, w1);
+        #pragma omp barrier
+        #pragma omp for reduction(max:rmax, bmax)
+        for (int i = 0; i < n; i++) {
+            rmax = max_nan(rmax, fabs(sys.b[i] - w1[i]));
+            if (fabs(sys.b[i]) > bmax) bmax = fabs(sys.b[i]);
+        }
+    }
+
+    // Per iteration: matrix entries (8 B value + 4 B index) plus vectors;
+    // Jacobi streams x, b, diag, inv_diag, x_new and row pointers/perm,
+    // CG streams x, r, p (twice) and q
+    double matrix_bytes = 12.0 * stored + (format == FORMAT_CSR ? 8.0 * n : 4.0 * n);
+    double vector_bytes = (solver == SOLVER_JACOBI ? 5.0 : 8.0) * 8.0 * n;
+    double flops_iter = 2.0 * sys.csr.nnz + (solver == SOLVER_JACOBI ? 4.0 : 10.0) * n;
+    printf("%d,%.6f,%d,%.3E,%s,%s,%d,%ld,%.3f,%.3f,%.3E\n", num_threads, t_cpu, iteration, norme,
+           format_names[format], solver_names[solver], n, sys.csr.nnz,
+           iteration * (matrix_bytes + vector_bytes) / t_cpu * 1e-9,
+           iteration * flops_iter / t_cpu * 1e-9, rmax / bmax);
+
+    free(sys.csr.row_ptr); free(sys.csr.col); free(sys.csr.val);
+    free(sys.sell.chunk_ptr); free(sys.sell.width); free(sys.sell.perm);
+    free(sys.sell.col); free(sys.sell.val);
+    free(sys.diag); free(sys.inv_diag); free(sys.b); free(sys.partial);
+    free(x); free(w1); free(w2); free(w3);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+// sched_setaffinity / sched_getcpu need _GNU_SOURCE defined before the first
+// system header, so programs using this file define it on their first line.
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+
+// Thread binding and page placement policies for the TP3 kernels.
+//
+// The NUMA topology comes from /sys/devices/system/node (node*/cpulist),
+// restricted to the CPUs this process may run on. Without that directory the
+// machine is treated as a single node.
+//
+// Binding (where threads run):
+//   none     leave it to the OS (original behaviour)
+//   compact  fill node 0's CPUs first, then node 1, ...
+//   spread   round-robin threads over nodes
+// Placement (where pages land, decided by the first write to each page):
+//   serial      the master thread touches everything -> all on its node
+//   interleave  pages round-robin over the nodes that hold team threads
+//   firsttouch  rows touched with schedule(static), i.e. by the thread that
+//               computes them in a static row-block compute loop
+//
+// Usage:
+//   topology_t topo; topo_read(&topo);
+//   place_bind_threads(&topo, bind);          // inside the final team size
+//   place_touch(a, rows, cols, &topo, place); // before initializing a
+
+#define PLACE_MAX_NODES 64
+#define PLACE_MAX_CPUS 1024
+
+typedef enum { BIND_NONE, BIND_COMPACT, BIND_SPREAD } bind_t;
+typedef enum { PLACE_SERIAL, PLACE_INTERLEAVE, PLACE_FIRSTTOUCH } place_t;
+
+typedef struct {
+    int nnodes;
+    int ncpus;                              // usable CPUs over all nodes
+    int count[PLACE_MAX_NODES];             // usable CPUs of each node
+    int cpus[PLACE_MAX_NODES][PLACE_MAX_CPUS / 8];
+    int node_of_cpu[PLACE_MAX_CPUS];        // -1 for CPUs we cannot use
+} topology_t;
+
+static const char *bind_names[] = {"none", "compact", "spread"};
+static const char *place_names[] = {"serial", "interleave", "firsttouch"};
+
+static inline bind_t place_parse_bind(const char *s) {
+    if (strcmp(s, "compact") == 0) return BIND_COMPACT;
+    if (strcmp(s, "spread") == 0) return BIND_SPREAD;
+    return BIND_NONE;
+}
+
+static inline place_t place_parse(const char *s) {
+    if (strcmp(s, "interleave") == 0) return PLACE_INTERLEAVE;
+    if (strcmp(s, "firsttouch") == 0) return PLACE_FIRSTTOUCH;
+    return PLACE_SERIAL;
+}
+
+// Parses a sysfs cpu list such as "0-13,28-41" and adds the allowed CPUs to node
+static inline void topo_add_cpulist(topology_t *t, int node, const char *list,
+                                    const cpu_set_t *allowed) {
+    const char *p = list;
+    while (*p && *p != '\n') {
+        char *end;
+        long lo = strtol(p, &end, 10), hi = lo;
+        if (end == p) break;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi && c < PLACE_MAX_CPUS; c++) {
+            if (!CPU_ISSET(c, allowed) || t->count[node] >= PLACE_MAX_CPUS / 8) continue;
+            t->cpus[node][t->count[node]++] = (int)c;
+            t->node_of_cpu[c] = node;
+            t->ncpus++;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+}
+
+// Fills t from sysfs; returns the number of nodes with usable CPUs
+static inline int topo_read(topology_t *t) {
+    cpu_set_t allowed;
+    memset(t, 0, sizeof(*t));
+    for (int c = 0; c < PLACE_MAX_CPUS; c++) t->node_of_cpu[c] = -1;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+        for (int c = 0; c < PLACE_MAX_CPUS; c++) CPU_SET(c, &allowed);
+    }
+
+    for (int node = 0; node < PLACE_MAX_NODES; node++) {
+        char path[96], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        if (fgets(list, sizeof(list), f)) {
+            // Memory-only nodes and nodes outside our cpuset keep count 0 and are dropped
+            topo_add_cpulist(t, t->nnodes, list, &allowed);
+            if (t->count[t->nnodes] > 0) t->nnodes++;
+        }
+        fclose(f);
+    }
+
+    // No sysfs: one node holding every usable CPU
+    if (t->nnodes == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int c = 0; c < n && c < PLACE_MAX_CPUS && t->count[0] < PLACE_MAX_CPUS / 8; c++) {
+            if (!CPU_ISSET(c, &allowed)) continue;
+            t->cpus[0][t->count[0]++] = c;
+            t->node_of_cpu[c] = 0;
+            t->ncpus++;
+        }
+        t->nnodes = 1;
+    }
+    return t->nnodes;
+}
+
+// CPU assigned to thread tid under a binding policy
+static inline int place_cpu_for_thread(const topology_t *t, bind_t bind, int tid) {
+    if (bind == BIND_COMPACT) {
+        int k = tid % t->ncpus;
+        for (int node = 0; node < t->nnodes; node++) {
+            if (k < t->count[node]) return t->cpus[node][k];
+            k -= t->count[node];
+        }
+    }
+    int node = tid % t->nnodes;
+    int k = (tid / t->nnodes) % t->count[node];
+    return t->cpus[node][k];
+}
+
+// Pins every thread of the next parallel region. libgomp reuses its threads,
+// so the binding holds for later regions with the same team size.
+static inline void place_bind_threads(const topology_t *t, bind_t bind) {
+    if (bind == BIND_NONE) return;
+    #pragma omp parallel
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(place_cpu_for_thread(t, bind, omp_get_thread_num()), &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            perror("sched_setaffinity");
+    }
+}
+
+// Node the calling thread is running on
+static inline int place_current_node(const topology_t *t) {
+    int cpu = sched_getcpu();
+    if (cpu < 0 || cpu >= PLACE_MAX_CPUS || t->node_of_cpu[cpu] < 0) return 0;
+    return t->node_of_cpu[cpu];
+}
+
+// Interleave worker: page g goes to used node g % nused and is shared
+// round-robin by the threads running on that node. Pages are the OS pages
+// under p (malloc does not page-align), numbered from the one holding p[0],
+// so each OS page is written by exactly one thread.
+static inline void place_touch_pages(double *p, long total, long page_bytes,
+                                     const int *thread_node, int nt, int tid, int nnodes) {
+    int used[PLACE_MAX_NODES] = {0}, nused = 0, slot = 0, rank = 0, peers = 0;
+    for (int k = 0; k < nt; k++) used[thread_node[k]] = 1;
+    for (int node = 0; node < nnodes; node++) {
+        if (node == thread_node[tid]) slot = nused;
+        nused += used[node];
+    }
+    for (int k = 0; k < nt; k++) {
+        if (thread_node[k] != thread_node[tid]) continue;
+        if (k < tid) rank++;
+        peers++;
+    }
+    uintptr_t start = (uintptr_t)p, base = start & ~(uintptr_t)(page_bytes - 1);
+    uintptr_t stop = (uintptr_t)(p + total);
+    long npages = (long)((stop - base + page_bytes - 1) / page_bytes);
+    for (long g = slot; g < npages; g += nused) {
+        if ((g / nused) % peers != rank) continue;
+        uintptr_t lo = base + (uintptr_t)g * page_bytes, hi = lo + page_bytes;
+        if (lo < start) lo = start;
+        if (hi > stop) hi = stop;
+        memset((char *)lo, 0, hi - lo);
+    }
+}
+
+// Zeroes a rows x cols matrix (or a vector with rows = n, cols = 1) so that
+// its pages land according to the policy. Values are written afterwards by
+// the program's own initialization, which no longer moves the pages.
+static inline void place_touch(double *p, long rows, long cols, const topology_t *t,
+                               place_t place) {
+    if (place == PLACE_SERIAL) {
+        memset(p, 0, rows * cols * sizeof(double));
+    } else if (place == PLACE_FIRSTTOUCH) {
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < rows; i++)
+            memset(p + i * cols, 0, cols * sizeof(double));
+    } else {
+        long page = sysconf(_SC_PAGESIZE);
+        int thread_node[PLACE_MAX_CPUS];
+        #pragma omp parallel
+        {
+            int tid = omp_get_thread_num();
+            int nt = omp_get_num_threads() < PLACE_MAX_CPUS ? omp_get_num_threads() : PLACE_MAX_CPUS;
+            if (tid < nt) thread_node[tid] = place_current_node(t);
+            #pragma omp barrier
+            if (tid < nt)
+                place_touch_pages(p, rows * cols, page, thread_node, nt, tid, t->nnodes);
+        }
+    }
+}
+
+#endif
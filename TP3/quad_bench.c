@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "quadrature.h"
+
+// Time-to-accuracy benchmark for the pi integrand of Exercise2/3 using the
+// quadrature engine. For each rule, n is doubled until |result - pi| <= tol;
+// the row reports the n reached, integrand evaluations and time.
+// Build: gcc -O2 -march=native -fopenmp quad_bench.c -o quad_bench -lm
+// Usage: ./quad_bench [tol] [threads]
+
+QUAD_DEFINE(pi4, 4.0 / (1.0 + x * x))
+
+#define MAX_N (1LL << 34)
+
+// Exercise2's cyclic distribution, kept for comparison
+double pi_cyclic(long long n) {
+    double step = 1.0 / n, sum = 0.0;
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        double local_sum = 0.0;
+        for (long long i = id; i < n; i += nt) {
+            double x = (i + 0.5) * step;
+            local_sum += 4.0 / (1.0 + x * x);
+        }
+        #pragma omp atomic
+        sum += local_sum;
+    }
+    return sum * step;
+}
+
+double gx4[4], gw4[4], gx8[8], gw8[8];
+
+double run_rule(int rule, long long n) {
+    switch (rule) {
+    case 0: return pi_cyclic(n);
+    case 1: return pi4_midpoint(0.0, 1.0, n);
+    case 2: return pi4_simpson(0.0, 1.0, n);
+    case 3: return pi4_gauss(0.0, 1.0, n, 4, gx4, gw4);
+    default: return pi4_gauss(0.0, 1.0, n, 8, gx8, gw8);
+    }
+}
+
+long long evals_per_panel(int rule) {
+    switch (rule) {
+    case 0: case 1: return 1;
+    case 2: return 2;
+    case 3: return 4;
+    default: return 8;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    double tol = 1e-12;
+    int num_threads = omp_get_max_threads();
+    const char *names[] = {"midpoint_cyclic", "midpoint", "simpson", "gauss4", "gauss8"};
+
+    if (argc > 1) tol = atof(argv[1]);
+    if (argc > 2) num_threads = atoi(argv[2]);
+    omp_set_num_threads(num_threads);
+
+    quad_gauss_init(4, gx4, gw4);
+    quad_gauss_init(8, gx8, gw8);
+
+    printf("Rule,Threads,Tol,N,Evals,Error,Time_final_s,Time_search_s\n");
+    for (int rule = 0; rule < 5; rule++) {
+        long long n = 1;
+        double result = 0.0, t_final = 0.0;
+        double t_search = omp_get_wtime();
+        for (;;) {
+            double t0 = omp_get_wtime();
+            result = run_rule(rule, n);
+            t_final = omp_get_wtime() - t0;
+            if (fabs(result - M_PI) <= tol || n >= MAX_N) break;
+            n *= 2;
+        }
+        t_search = omp_get_wtime() - t_search;
+        printf("%s,%d,%.1e,%lld,%lld,%.3e,%.6f,%.6f\n", names[rule], num_threads, tol, n,
+               n * evals_per_panel(rule), fabs(result - M_PI), t_final, t_search);
+    }
+
+    // Adaptive Simpson: the tolerance drives the refinement directly
+    long long evals;
+    double t0 = omp_get_wtime();
+    double result = pi4_adaptive(0.0, 1.0, tol, &evals);
+    double t = omp_get_wtime() - t0;
+    printf("adaptive_simpson,%d,%.1e,-,%lld,%.3e,%.6f,%.6f\n", num_threads, tol, evals,
+           fabs(result - M_PI), t, t);
+
+    return 0;
+}
@@ -1,80 +1,742 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #ifdef _OPENMP
 #include <omp.h>
-#endif 
+#else
+#define omp_get_thread_num() 0
+#define omp_get_num_threads() 1
+#define omp_get_max_threads() 1
+#define omp_get_wtime() ((double)clock() / CLOCKS_PER_SEC)
+#endif
 
 #define N 1000000
 
-int main(){
+// Sum, max and standard deviation of A, plus exact quantiles and a histogram.
+// Usage: ./exercise1 [N] [welford|sections|sort] [bins]
+//        ./exercise1 <file|-> stream [bins] [chunk_MB] [lo] [hi]
+//   welford   (default) one parallel pass: every thread folds a contiguous
+//             chunk into a (count, mean, M2, min, max) state, and the
+//             states are merged pairwise in a tree, so all cores work and A
+//             is read once; then the histogram and the quantiles
+//   sections  the original version: sum and max in two omp sections (at
+//             most 2 threads), then a second pass for the deviation
+//   sort      welford, but quantiles from a full sort of a copy (reference)
+//   bins      histogram bins over [min, max] (default 16, 0 = none)
+//   stream    raw native doubles from a file or stdin ("-") instead of the
+//             rand() array, with bounded memory (see below)
+// Welford states are numerically stable: M2 accumulates squared deviations
+// from a running mean instead of sum(x^2) - n mean^2. Inside a chunk the
+// data is taken in WELFORD_BLOCK-element blocks: a vectorized sum / min / max
+// gives the block mean, a second sweep of the block (still in L1) its M2,
+// and the block is merged like a thread state, which avoids one division
+// per element.
+//
+// Histogram: every thread counts its chunk into a private row of bins,
+// padded to whole cache lines so that no two threads write the same line,
+// and the rows are summed per bin in parallel at the end.
+//
+// Quantiles are exact order statistics, rank floor(q (N - 1)), found by
+// parallel sample-based splitting (Floyd-Rivest): sort a SELECT_SAMPLE
+// random sample, take splitters lo/hi around the expected position of the
+// rank, count in one parallel pass how many elements fall below lo and in
+// [lo, hi], and copy the [lo, hi] ones (a few percent of N) to a buffer that
+// is searched the same way. Buffers below SELECT_SERIAL elements finish with
+// a serial quickselect. All quantiles share the count and copy passes over
+// A: each thread walks its chunk in SELECT_BLOCK-element blocks and tests a
+// block against every window while it is in L1. A rank outside [lo, hi]
+// (unlikely) retries with a wider window.
+// Expected work is O(N) instead of the O(N log N) of a sort.
+//
+// Streaming: an I/O thread (pthread) reads fixed chunk_MB chunks into a ring
+// of RING_BUFS buffers, while the OpenMP team folds each finished chunk into
+// per-thread Welford states and histogram rows that live for the whole
+// stream; the states are tree-merged at the end. Memory stays at RING_BUFS
+// chunks whatever the input size, and reading overlaps folding as long as
+// the reader is not blocked on a full ring. The histogram range is fixed up
+// front, [lo, hi] (default [0, 1]), with underflow / overflow counts, and
+// exact quantiles are not available since the data is not kept. NaNs in the
+// input are counted and reported on their own, and left out of the count,
+// moments, min and max.
 
-    double *A = malloc(N * sizeof(double));
-    if (A == NULL) {
-        printf("Memory allocation failed\n");
-        return 1;
+#define WELFORD_BLOCK 1024
+#define LINE_LL 8             // long longs per cache line
+#define MAX_QUANTILES 8
+#define SELECT_SAMPLE 16384
+#define SELECT_SERIAL (1 << 20)
+#define SELECT_WIDTH 4.0      // half-window in sample standard deviations
+#define SELECT_BLOCK 2048     // doubles per L1-resident block of the passes
+#define RING_BUFS 4
+#define DEFAULT_CHUNK_MB 16
+
+// Cache-line aligned malloc that stops the program on failure; selection
+// buffers reach hundreds of MB at N = 1e9, and the alignment keeps the padded
+// per-thread histogram rows on their own lines. Released with free().
+void *xmalloc(size_t bytes) {
+    void *p = aligned_alloc(64, (bytes + 63) / 64 * 64);
+    if (p == NULL && bytes > 0) {
+        printf("Memory allocation failed (%zu bytes)\n", bytes);
+        exit(1);
+    }
+    return p;
+}
+
+typedef struct {
+    long long count;      // samples in the moments, NaNs excluded
+    long long nans;
+    double mean, m2, min, max;
+    char pad[64 - 2 * sizeof(long long) - 4 * sizeof(double)];
+} welford_t;
+
+void welford_init(welford_t *w) {
+    memset(w, 0, sizeof(*w));
+    w->min = INFINITY;
+    w->max = -INFINITY;
+}
+
+// Chan et al. pairwise update: a <- a + b
+void welford_merge(welford_t *a, const welford_t *b) {
+    a->nans += b->nans;
+    if (b->count == 0) return;
+    if (a->count == 0) {
+        long long nans = a->nans;
+        *a = *b;
+        a->nans = nans;
+        return;
+    }
+    long long n = a->count + b->count;
+    double delta = b->mean - a->mean;
+    a->mean += delta * ((double)b->count / n);
+    a->m2 += b->m2 + delta * delta * ((double)a->count * b->count / n);
+    a->count = n;
+    if (b->min < a->min) a->min = b->min;
+    if (b->max > a->max) a->max = b->max;
+}
+
+// Folds x[0:len] into w, block by block; NaNs (x != x) are only counted.
+// The min / max selects already skip them since every comparison is false.
+void welford_add(welford_t *w, const double *x, long long len) {
+    for (long long i0 = 0; i0 < len; i0 += WELFORD_BLOCK) {
+        long long m = len - i0 < WELFORD_BLOCK ? len - i0 : WELFORD_BLOCK;
+        const double *p = x + i0;
+        double sum = 0.0, mn = INFINITY, mx = -INFINITY;
+        long long valid = 0;
+        #pragma omp simd reduction(+:sum, valid) reduction(min:mn) reduction(max:mx)
+        for (long long i = 0; i < m; i++) {
+            int ok = p[i] == p[i];
+            sum += ok ? p[i] : 0.0;
+            valid += ok;
+            mn = p[i] < mn ? p[i] : mn;
+            mx = p[i] > mx ? p[i] : mx;
+        }
+        w->nans += m - valid;
+        if (valid == 0) continue;
+        double mean = sum / valid, m2 = 0.0;
+        #pragma omp simd reduction(+:m2)
+        for (long long i = 0; i < m; i++)
+            m2 += p[i] == p[i] ? (p[i] - mean) * (p[i] - mean) : 0.0;
+
+        welford_t blk;
+        welford_init(&blk);
+        blk.count = valid;
+        blk.mean = mean;
+        blk.m2 = m2;
+        blk.min = mn;
+        blk.max = mx;
+        welford_merge(w, &blk);
+    }
+}
+
+// Merges the team's states into state[0] in a log2(threads) tree; called by
+// every thread of the team
+void welford_tree_merge(welford_t *state) {
+    int id = omp_get_thread_num();
+    int p = omp_get_num_threads();
+    // Level s: thread id (a multiple of 2s) absorbs thread id + s
+    for (int s = 1; s < p; s *= 2) {
+        #pragma omp barrier
+        if (id % (2 * s) == 0 && id + s < p)
+            welford_merge(&state[id], &state[id + s]);
+    }
+}
+
+// Single parallel pass over A, states merged in a tree
+welford_t stats_welford(const double *A, long long n) {
+    int nt = omp_get_max_threads();
+    welford_t *state = xmalloc(nt * sizeof(welford_t));
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int p = omp_get_num_threads();
+        welford_init(&state[id]);
+        welford_add(&state[id], A + n * id / p, n * (id + 1) / p - n * id / p);
+        welford_tree_merge(state);
+    }
+
+    welford_t total = state[0];
+    free(state);
+    return total;
+}
+
+// Per-thread histogram rows: bins counts, then underflow, overflow and NaN,
+// padded to whole cache lines. The NaN slot is only a sink for hist_add; the
+// NaN count is printed from the Welford state.
+#define HIST_EXTRA 3
+
+static inline int hist_stride(int bins) {
+    return (bins + HIST_EXTRA + LINE_LL - 1) / LINE_LL * LINE_LL;
+}
+
+// Counts x[0:n] into row; hi itself goes to the last bin. NaNs fail every
+// comparison, so they are caught before the (int) conversion, which would be
+// undefined for them.
+void hist_add(long long *row, const double *x, long long n, double lo, double hi, int bins) {
+    double scale = hi > lo ? bins / (hi - lo) : 0.0;
+    for (long long i = 0; i < n; i++) {
+        if (x[i] < lo) {
+            row[bins]++;
+        } else if (x[i] > hi) {
+            row[bins + 1]++;
+        } else if (x[i] >= lo) {
+            int b = (int)((x[i] - lo) * scale);
+            row[b < 0 ? 0 : b < bins ? b : bins - 1]++;
+        } else {
+            row[bins + 2]++;
+        }
+    }
+}
+
+// Sums the team's rows into hist[0:bins + HIST_EXTRA]; called by every thread of the team
+void hist_merge(const long long *rows, int bins, long long *hist) {
+    int p = omp_get_num_threads(), stride = hist_stride(bins);
+    #pragma omp barrier
+    #pragma omp for schedule(static)
+    for (int b = 0; b < bins + HIST_EXTRA; b++) {
+        long long c = 0;
+        for (int t = 0; t < p; t++) c += rows[(size_t)t * stride + b];
+        hist[b] = c;
+    }
+}
+
+// Histogram of x over [lo, hi] into hist[0:bins + HIST_EXTRA]
+void histogram(const double *x, long long n, double lo, double hi, int bins,
+               long long *hist) {
+    int nt = omp_get_max_threads(), stride = hist_stride(bins);
+    long long *rows = xmalloc((size_t)nt * stride * sizeof(long long));
+
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int p = omp_get_num_threads();
+        long long *row = rows + (size_t)id * stride;
+        memset(row, 0, stride * sizeof(long long));
+        hist_add(row, x + n * id / p, n * (id + 1) / p - n * id / p, lo, hi, bins);
+        hist_merge(rows, bins, hist);
+    }
+    free(rows);
+}
+
+// seconds < 0: no timing line (the streaming histogram is fused with the fold)
+void print_histogram(const long long *hist, int bins, double lo, double hi, double seconds) {
+    double width = (hi - lo) / bins;
+    if (seconds >= 0.0) printf("Histogram (%d bins, %f s)\n", bins, seconds);
+    else printf("Histogram (%d bins)\n", bins);
+    for (int b = 0; b < bins; b++)
+        printf("  [%f, %f%c %lld\n", lo + b * width, lo + (b + 1) * width,
+               b == bins - 1 ? ']' : ')', hist[b]);
+    if (hist[bins] || hist[bins + 1])
+        printf("  underflow %lld, overflow %lld\n", hist[bins], hist[bins + 1]);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Element of rank k of x[0:n], partially reordering x
+double quickselect(double *x, long long n, long long k) {
+    long long lo = 0, hi = n - 1;
+    while (lo < hi) {
+        // Median of three as pivot, Hoare partition
+        long long mid = lo + (hi - lo) / 2;
+        double a = x[lo], b = x[mid], c = x[hi];
+        double pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        long long i = lo, j = hi;
+        while (i <= j) {
+            while (x[i] < pivot) i++;
+            while (x[j] > pivot) j--;
+            if (i <= j) {
+                double t = x[i];
+                x[i] = x[j];
+                x[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else return x[k];
+    }
+    return x[k];
+}
+
+static inline unsigned long long splitmix64(unsigned long long z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Elements of ranks[0:nq] of x[0:n] (x is not modified)
+void select_ranks(const double *x, long long n, const long long *ranks, int nq, double *out) {
+    if (n <= SELECT_SERIAL) {
+        double *tmp = xmalloc(n * sizeof(double));
+        memcpy(tmp, x, n * sizeof(double));
+        for (int q = 0; q < nq; q++) out[q] = quickselect(tmp, n, ranks[q]);
+        free(tmp);
+        return;
+    }
+
+    double *sample = xmalloc(SELECT_SAMPLE * sizeof(double));
+    #pragma omp parallel for schedule(static)
+    for (int s = 0; s < SELECT_SAMPLE; s++)
+        sample[s] = x[splitmix64((unsigned long long)s * 7919 + n) % n];
+    qsort(sample, SELECT_SAMPLE, sizeof(double), cmp_double);
+
+    int pending[MAX_QUANTILES], npending = nq;
+    double width = SELECT_WIDTH;
+    for (int q = 0; q < nq; q++) pending[q] = q;
+
+    while (npending > 0) {
+        // Splitters: the sample ranks around k s / n, +- width sqrt(s)
+        double lo[MAX_QUANTILES], hi[MAX_QUANTILES];
+        for (int j = 0; j < npending; j++) {
+            double pos = (double)ranks[pending[j]] * SELECT_SAMPLE / n;
+            double half = width * sqrt((double)SELECT_SAMPLE);
+            long long a = (long long)(pos - half), b = (long long)(pos + half);
+            lo[j] = a < 0 ? -INFINITY : sample[a];
+            hi[j] = b >= SELECT_SAMPLE ? INFINITY : sample[b];
+        }
+
+        int nt = omp_get_max_threads();
+        long long (*below)[MAX_QUANTILES] = xmalloc(nt * sizeof(*below));
+        long long (*inside)[MAX_QUANTILES] = xmalloc(nt * sizeof(*inside));
+        long long total_below[MAX_QUANTILES], total_inside[MAX_QUANTILES];
+        double *buf[MAX_QUANTILES] = {NULL};
+
+        #pragma omp parallel
+        {
+            int id = omp_get_thread_num();
+            int p = omp_get_num_threads();
+            long long begin = n * id / p, end = n * (id + 1) / p;
+
+            // Count pass: every block against all pending windows
+            long long cb[MAX_QUANTILES] = {0}, ci[MAX_QUANTILES] = {0};
+            for (long long b0 = begin; b0 < end; b0 += SELECT_BLOCK) {
+                long long b1 = b0 + SELECT_BLOCK < end ? b0 + SELECT_BLOCK : end;
+                for (int j = 0; j < npending; j++) {
+                    long long nb = 0, ni = 0;
+                    double l = lo[j], h = hi[j];
+                    #pragma omp simd reduction(+:nb, ni)
+                    for (long long i = b0; i < b1; i++) {
+                        nb += x[i] < l;
+                        ni += (x[i] >= l) & (x[i] <= h);
+                    }
+                    cb[j] += nb;
+                    ci[j] += ni;
+                }
+            }
+            for (int j = 0; j < npending; j++) {
+                below[id][j] = cb[j];
+                inside[id][j] = ci[j];
+            }
+            #pragma omp barrier
+
+            // Per-thread write offsets; buffers only for ranks inside their window
+            #pragma omp single
+            for (int j = 0; j < npending; j++) {
+                long long k = ranks[pending[j]], cb = 0, ci = 0;
+                for (int t = 0; t < p; t++) {
+                    long long c = inside[t][j];
+                    cb += below[t][j];
+                    inside[t][j] = ci;
+                    ci += c;
+                }
+                total_below[j] = cb;
+                total_inside[j] = ci;
+                if (k >= cb && k < cb + ci) buf[j] = xmalloc(ci * sizeof(double));
+            }
+
+            // Copy pass, blocked the same way
+            double *dst[MAX_QUANTILES];
+            for (int j = 0; j < npending; j++)
+                dst[j] = buf[j] ? buf[j] + inside[id][j] : NULL;
+            for (long long b0 = begin; b0 < end; b0 += SELECT_BLOCK) {
+                long long b1 = b0 + SELECT_BLOCK < end ? b0 + SELECT_BLOCK : end;
+                for (int j = 0; j < npending; j++) {
+                    if (!dst[j]) continue;
+                    double l = lo[j], h = hi[j];
+                    for (long long i = b0; i < b1; i++)
+                        if (x[i] >= l && x[i] <= h) *dst[j]++ = x[i];
+                }
+            }
+        }
+
+        int still = 0;
+        for (int j = 0; j < npending; j++) {
+            int q = pending[j];
+            if (!buf[j]) {
+                pending[still++] = q;
+                continue;
+            }
+            // The buffer is ours: when it did not shrink (heavy ties), select in place
+            long long k = ranks[q] - total_below[j];
+            if (total_inside[j] == n) out[q] = quickselect(buf[j], n, k);
+            else select_ranks(buf[j], total_inside[j], &k, 1, &out[q]);
+            free(buf[j]);
+        }
+        npending = still;
+        width *= 4.0;
+        free(below);
+        free(inside);
     }
+    free(sample);
+}
 
+// Original version, kept for comparison
+void stats_sections(const double *A, long long n, double *sum_out, double *max_out,
+                    double *stddev_out) {
     double sum = 0.0;
     double mean = 0.0;
     double stddev = 0.0;
-    double max;
+    double max = A[0];
 
-    // Initialization
-    srand(0);
-    for (int i = 0; i < N; i++)
-        A[i] = (double)rand() / RAND_MAX;
-    
-    sum = 0.0;
-    max = A[0];
-    
     #pragma omp parallel sections
     {
-        #pragma omp section 
+        #pragma omp section
         {
-            double local_sum = 0.0;  
-            for (int i = 0; i < N; i++) {
+            double local_sum = 0.0;
+            for (long long i = 0; i < n; i++) {
                 local_sum += A[i];
             }
-            #pragma omp atomic 
-            sum += local_sum;  
+            #pragma omp atomic
+            sum += local_sum;
         }
-        
-        #pragma omp section 
+
+        #pragma omp section
         {
             double local_max = A[0];
-            for (int i = 0; i < N; i++) {
-                if (A[i] > local_max)  
+            for (long long i = 0; i < n; i++) {
+                if (A[i] > local_max)
                     local_max = A[i];
             }
             #pragma omp critical
             {
                 if (local_max > max)
                     max = local_max;
-            } 
+            }
         }
     }
-    
-    mean = sum / N;
 
-    #pragma omp parallel 
+    mean = sum / n;
+
+    #pragma omp parallel
     {
-        double local_stddev = 0.0;  
-        #pragma omp for  
-        for (int i = 0; i < N; i++) {
+        double local_stddev = 0.0;
+        #pragma omp for
+        for (long long i = 0; i < n; i++) {
             local_stddev += (A[i] - mean) * (A[i] - mean);
         }
         #pragma omp atomic
         stddev += local_stddev;
     }
 
-    stddev = sqrt(stddev / N);
-    
+    *sum_out = sum;
+    *max_out = max;
+    *stddev_out = sqrt(stddev / n);
+}
+
+/* ---------------- streaming input ---------------- */
+
+// Ring of chunk buffers between the reader thread and the folding team.
+// Chunk g goes to buffer g % RING_BUFS; ready and consumed count chunks.
+typedef struct {
+    int fd;
+    size_t chunk_bytes;
+    char *buf[RING_BUFS];
+    size_t len[RING_BUFS];      // bytes in each buffer
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    long long ready, consumed;
+    int eof, error;             // error: errno of a failed read(), else 0
+    double t_read;              // reader time inside read()
+} ring_t;
+
+typedef struct {
+    long long bytes;
+    double t_read, t_fold, t_stall;
+    int error;                  // errno of a failed read(), else 0
+} ingest_t;
+
+// Fills buffers in order; pipes return short reads, so a chunk is only short
+// at the end of the input
+void *ring_reader(void *arg) {
+    ring_t *r = arg;
+    for (long long g = 0;; g++) {
+        pthread_mutex_lock(&r->lock);
+        while (g - r->consumed >= RING_BUFS) pthread_cond_wait(&r->cond, &r->lock);
+        pthread_mutex_unlock(&r->lock);
+
+        char *dst = r->buf[g % RING_BUFS];
+        size_t got = 0;
+        int err = 0;
+        double t0 = omp_get_wtime();
+        while (got < r->chunk_bytes) {
+            ssize_t k = read(r->fd, dst + got, r->chunk_bytes - got);
+            if (k < 0 && errno == EINTR) continue;
+            if (k < 0) {
+                err = errno;
+                break;
+            }
+            if (k == 0) break;
+            got += k;
+        }
+        r->t_read += omp_get_wtime() - t0;
+
+        pthread_mutex_lock(&r->lock);
+        r->len[g % RING_BUFS] = got;
+        if (got > 0) r->ready = g + 1;
+        if (got < r->chunk_bytes) {
+            r->eof = 1;
+            r->error = err;
+        }
+        pthread_cond_broadcast(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+        if (got < r->chunk_bytes) break;
+    }
+    return NULL;
+}
+
+// Welford state and histogram of a stream of doubles read from fd
+welford_t stats_stream(int fd, size_t chunk_bytes, int bins, double lo, double hi,
+                       long long *hist, ingest_t *io) {
+    int nt = omp_get_max_threads(), stride = hist_stride(bins);
+    welford_t *state = xmalloc(nt * sizeof(welford_t));
+    long long *rows = xmalloc((size_t)nt * stride * sizeof(long long));
+    ring_t r;
+    memset(&r, 0, sizeof(r));
+    r.fd = fd;
+    r.chunk_bytes = chunk_bytes;
+    for (int k = 0; k < RING_BUFS; k++) {
+        r.buf[k] = malloc(chunk_bytes);
+        if (!r.buf[k]) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    for (int t = 0; t < nt; t++) welford_init(&state[t]);
+    memset(rows, 0, (size_t)nt * stride * sizeof(long long));
+    memset(io, 0, sizeof(*io));
+    pthread_mutex_init(&r.lock, NULL);
+    pthread_cond_init(&r.cond, NULL);
+
+    pthread_t reader;
+    pthread_create(&reader, NULL, ring_reader, &r);
+
+    for (long long g = 0;; g++) {
+        double t0 = omp_get_wtime();
+        pthread_mutex_lock(&r.lock);
+        while (r.ready <= g && !r.eof) pthread_cond_wait(&r.cond, &r.lock);
+        int have = r.ready > g;
+        pthread_mutex_unlock(&r.lock);
+        double t1 = omp_get_wtime();
+        io->t_stall += t1 - t0;
+        if (!have) break;
+
+        size_t len = r.len[g % RING_BUFS];
+        if (len % sizeof(double))
+            fprintf(stderr, "Ignoring %zu trailing bytes\n", len % sizeof(double));
+        const double *x = (const double *)r.buf[g % RING_BUFS];
+        long long m = len / sizeof(double);
+        io->bytes += len;
+
+        #pragma omp parallel
+        {
+            int id = omp_get_thread_num();
+            int p = omp_get_num_threads();
+            long long begin = m * id / p, end = m * (id + 1) / p;
+            welford_add(&state[id], x + begin, end - begin);
+            if (bins > 0) hist_add(rows + (size_t)id * stride, x + begin, end - begin, lo, hi, bins);
+        }
+        io->t_fold += omp_get_wtime() - t1;
+
+        pthread_mutex_lock(&r.lock);
+        r.consumed = g + 1;
+        pthread_cond_broadcast(&r.cond);
+        pthread_mutex_unlock(&r.lock);
+    }
+    pthread_join(reader, NULL);
+    io->error = r.error;
+    io->t_read = r.t_read;
+
+    #pragma omp parallel
+    {
+        welford_tree_merge(state);
+        if (bins > 0) hist_merge(rows, bins, hist);
+    }
+
+    welford_t total = state[0];
+    for (int k = 0; k < RING_BUFS; k++) free(r.buf[k]);
+    pthread_mutex_destroy(&r.lock);
+    pthread_cond_destroy(&r.cond);
+    free(state);
+    free(rows);
+    return total;
+}
+
+int main_stream(int argc, char *argv[]) {
+    int bins = argc > 3 ? atoi(argv[3]) : 16;
+    double chunk_mb = argc > 4 ? atof(argv[4]) : DEFAULT_CHUNK_MB;
+    double lo = argc > 5 ? atof(argv[5]) : 0.0;
+    double hi = argc > 6 ? atof(argv[6]) : 1.0;
+    size_t chunk_bytes = (size_t)(chunk_mb * 1048576.0) / sizeof(double) * sizeof(double);
+    if (bins < 0 || chunk_bytes == 0 || !(hi > lo)) {
+        printf("bins must be non-negative, chunk_MB positive and lo < hi\n");
+        return 1;
+    }
+
+    int fd = strcmp(argv[1], "-") == 0 ? STDIN_FILENO : open(argv[1], O_RDONLY);
+    if (fd < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    long long *hist = xmalloc((bins + HIST_EXTRA) * sizeof(long long));
+    ingest_t io;
+    double t0 = omp_get_wtime();
+    welford_t w = stats_stream(fd, chunk_bytes, bins, lo, hi, hist, &io);
+    double elapsed = omp_get_wtime() - t0;
+    if (fd != STDIN_FILENO) close(fd);
+    if (io.error) {
+        fprintf(stderr, "read error on %s after %lld bytes: %s\n", argv[1], io.bytes,
+                strerror(io.error));
+        free(hist);
+        return 1;
+    }
+
+    printf("Samples = %lld\n", w.count);
+    printf("NaNs    = %lld\n", w.nans);
+    if (w.count > 0) {
+        printf("Mean    = %f\n", w.mean);
+        printf("Min     = %f\n", w.min);
+        printf("Sum     = %f\n", w.mean * w.count);
+        printf("Max     = %f\n", w.max);
+        printf("Std Dev = %f\n", sqrt(w.m2 / w.count));
+    }
+    printf("Time    = %f s (stream, %d threads, %d x %.1f MB buffers)\n", elapsed,
+           omp_get_max_threads(), RING_BUFS, chunk_bytes / 1048576.0);
+    printf("Ingest  = %.3f GB/s (read %f s, fold %f s, fold waiting for data %f s)\n",
+           io.bytes / elapsed * 1e-9, io.t_read, io.t_fold, io.t_stall);
+    if (bins > 0 && w.count > 0) print_histogram(hist, bins, lo, hi, -1.0);
+    free(hist);
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    if (argc > 2 && strcmp(argv[2], "stream") == 0)
+        return main_stream(argc, argv);
+
+    long long n = N;
+    int sections = 0, sort = 0, bins = 16;
+
+    if (argc > 1) n = atoll(argv[1]);
+    if (argc > 2) {
+        sections = strcmp(argv[2], "sections") == 0;
+        sort = strcmp(argv[2], "sort") == 0;
+    }
+    if (argc > 3) bins = atoi(argv[3]);
+    if (n < 1 || bins < 0) {
+        printf("N must be positive and bins non-negative\n");
+        return 1;
+    }
+
+    double *A = malloc(n * sizeof(double));
+    if (A == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    double sum, max, stddev, min = 0.0;
+
+    // Initialization
+    srand(0);
+    for (long long i = 0; i < n; i++)
+        A[i] = (double)rand() / RAND_MAX;
+
+    double t0 = omp_get_wtime();
+    if (sections) {
+        stats_sections(A, n, &sum, &max, &stddev);
+    } else {
+        welford_t w = stats_welford(A, n);
+        sum = w.mean * w.count;
+        max = w.max;
+        min = w.min;
+        stddev = sqrt(w.m2 / w.count);
+        printf("Mean    = %f\n", w.mean);
+        printf("Min     = %f\n", w.min);
+    }
+    double elapsed = omp_get_wtime() - t0;
+
     printf("Sum     = %f\n", sum);
     printf("Max     = %f\n", max);
     printf("Std Dev = %f\n", stddev);
+    printf("Time    = %f s (%s, %d threads, %.3f GB/s)\n", elapsed,
+           sections ? "sections" : "welford", omp_get_max_threads(),
+           8.0 * n / elapsed * 1e-9);
+
+    if (!sections) {
+        static const double quantiles[] = {0.5, 0.99, 0.999};
+        static const char *quantile_names[] = {"Median", "P99", "P999"};
+        const int nq = 3;
+        long long ranks[3];
+        double values[3];
+        for (int q = 0; q < nq; q++) ranks[q] = (long long)(quantiles[q] * (n - 1));
+
+        t0 = omp_get_wtime();
+        if (sort) {
+            double *copy = malloc(n * sizeof(double));
+            if (copy == NULL) {
+                printf("Memory allocation failed\n");
+                return 1;
+            }
+            memcpy(copy, A, n * sizeof(double));
+            qsort(copy, n, sizeof(double), cmp_double);
+            for (int q = 0; q < nq; q++) values[q] = copy[ranks[q]];
+            free(copy);
+        } else {
+            select_ranks(A, n, ranks, nq, values);
+        }
+        double t_quantiles = omp_get_wtime() - t0;
+
+        for (int q = 0; q < nq; q++) printf("%-7s = %f\n", quantile_names[q], values[q]);
+        printf("Time    = %f s (quantiles by %s)\n", t_quantiles, sort ? "sort" : "selection");
+
+        if (bins > 0) {
+            long long *hist = xmalloc((bins + HIST_EXTRA) * sizeof(long long));
+            t0 = omp_get_wtime();
+            histogram(A, n, min, max, bins, hist);
+            print_histogram(hist, bins, min, max, omp_get_wtime() - t0);
+            free(hist);
+        }
+    }
 
     free(A);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+
+// Reproducible OpenMP sum: same bits for any thread count.
+// Uses pre-rounded (binned) accumulation: every term is split onto RSUM_LEVELS
+// fixed power-of-two grids chosen from the global max and N only. Sums on a
+// grid are exact, so the order in which threads combine them does not matter.
+// Build WITHOUT -ffast-math:
+//   gcc -O2 -fopenmp reproducible_sum.c -o reproducible_sum -lm
+// Usage: ./reproducible_sum [N] [max_threads]
+
+#define RSUM_LEVELS 3
+#define REPS 5
+
+// Extraction constant for n terms bounded by m: 2^(e + ceil(log2 n) + 1)
+double rsum_sigma(double m, long long n) {
+    int e, lg = 0;
+    if (m == 0.0) return 0.0;
+    frexp(m, &e);
+    while ((1LL << lg) < n) lg++;
+    return ldexp(1.0, e + lg + 1);
+}
+
+// Grids for every level, derived from the global bound only
+void rsum_grids(double max_abs, long long n, double *sigma) {
+    double m = max_abs;
+    for (int l = 0; l < RSUM_LEVELS; l++) {
+        sigma[l] = rsum_sigma(m, n);
+        m = ldexp(sigma[l], -52);   // bound on what is left after this level
+    }
+}
+
+// Accumulate a[begin:end] into acc[] (exact, order independent)
+void rsum_accumulate(const double *a, long long begin, long long end,
+                     const double *sigma, double *acc) {
+    double s0 = sigma[0], s1 = sigma[1], s2 = sigma[2];
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0;
+
+    // Reassociating the lane sums is safe here: every partial sum is exact
+    #pragma omp simd reduction(+:acc0,acc1,acc2)
+    for (long long i = begin; i < end; i++) {
+        double x = a[i];
+        double q = (s0 + x) - s0;
+        acc0 += q; x -= q;
+        q = (s1 + x) - s1;
+        acc1 += q; x -= q;
+        q = (s2 + x) - s2;
+        acc2 += q;
+    }
+    acc[0] += acc0;
+    acc[1] += acc1;
+    acc[2] += acc2;
+}
+
+double rsum_finalize(const double *acc) {
+    return acc[0] + (acc[1] + acc[2]);
+}
+
+double reproducible_sum(const double *a, long long n) {
+    double max_abs = 0.0;
+    #pragma omp parallel for reduction(max:max_abs)
+    for (long long i = 0; i < n; i++) {
+        double v = fabs(a[i]);
+        if (v > max_abs) max_abs = v;
+    }
+
+    double sigma[RSUM_LEVELS];
+    rsum_grids(max_abs, n, sigma);
+
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0;
+    #pragma omp parallel reduction(+:acc0,acc1,acc2)
+    {
+        int id = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        long long begin = n * id / nt;
+        long long end   = n * (id + 1) / nt;
+        double acc[RSUM_LEVELS] = {0.0, 0.0, 0.0};
+        rsum_accumulate(a, begin, end, sigma, acc);
+        acc0 += acc[0];
+        acc1 += acc[1];
+        acc2 += acc[2];
+    }
+
+    double acc[RSUM_LEVELS] = {acc0, acc1, acc2};
+    return rsum_finalize(acc);
+}
+
+double native_sum(const double *a, long long n) {
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum)
+    for (long long i = 0; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+int main(int argc, char *argv[]) {
+    long long n = 100000000LL;
+    int max_threads = omp_get_max_threads();
+
+    if (argc > 1) n = atoll(argv[1]);
+    if (argc > 2) max_threads = atoi(argv[2]);
+
+    double *a = malloc(n * sizeof(double));
+    if (a == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    // Mixed signs and magnitudes so that rounding depends on summation order
+    srand(0);
+    for (long long i = 0; i < n; i++) {
+        double r = (double)rand() / RAND_MAX;
+        a[i] = (r - 0.5) * pow(10.0, (i % 7) - 3);
+    }
+
+    printf("Threads,Native_Sum,Native_Time,Repro_Sum,Repro_Time,Overhead\n");
+    for (int t = 1; t <= max_threads; t *= 2) {
+        omp_set_num_threads(t);
+        double s_nat = 0.0, s_rep = 0.0;
+        double best_nat = 1e30, best_rep = 1e30;
+
+        for (int rep = 0; rep < REPS; rep++) {
+            double t0 = omp_get_wtime();
+            s_nat = native_sum(a, n);
+            double t1 = omp_get_wtime();
+            s_rep = reproducible_sum(a, n);
+            double t2 = omp_get_wtime();
+            if (t1 - t0 < best_nat) best_nat = t1 - t0;
+            if (t2 - t1 < best_rep) best_rep = t2 - t1;
+        }
+        // %a prints the exact bits, so any drift between rows is visible
+        printf("%d,%a,%.6f,%a,%.6f,%.2f\n",
+               t, s_nat, best_nat, s_rep, best_rep, best_rep / best_nat);
+    }
+
+    free(a);
+    return 0;
+}
@@ -2,6 +2,51 @@
 #include <stdlib.h>
 #include <math.h>
 #include <mpi.h>
+#include "../TP3/quadrature.h"
+
+// High-order modes: Gauss-Legendre panels and Romberg extrapolation reach
+// machine precision with a few hundred evaluations instead of N. The Gauss
+// panel count is fixed on the command line and split into contiguous blocks
+// over the ranks, so the result does not depend on the number of processes.
+// Build: mpicc -O2 Exercise5.c -o Exercise5 -lm    (add -fopenmp for threads)
+// Usage: mpirun -np <p> ./Exercise5 <N> [gauss_panels]
+#define GAUSS_POINTS 8
+#define GAUSS_PANELS 16
+#define ROMBERG_LEVELS 10
+
+QUAD_DEFINE(pi_f, 1.0 / (1.0 + x * x))
+
+// Romberg on [0,1]: level k (1..levels) adds 2^(k-1) new midpoints to the
+// trapezoid rule. Every level's new points are split across ranks and all
+// level sums are reduced in one MPI_Allreduce; the tableau is then built
+// redundantly on each rank.
+double romberg_mpi(int levels, int rank, int size_mpi, long long *evals) {
+    double local[ROMBERG_LEVELS + 1] = {0.0}, level_sum[ROMBERG_LEVELS + 1];
+    double R[ROMBERG_LEVELS + 1][ROMBERG_LEVELS + 1];
+
+    if (rank == 0) local[0] = 0.5 * (pi_f_f(0.0) + pi_f_f(1.0));
+    *evals = 2;
+    for (int k = 1; k <= levels; k++) {
+        long long count = 1LL << (k - 1);
+        double h = 1.0 / count;
+        for (long long i = rank; i < count; i += size_mpi)
+            local[k] += pi_f_f((i + 0.5) * h);
+        *evals += count;
+    }
+    MPI_Allreduce(local, level_sum, levels + 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    R[0][0] = level_sum[0];
+    for (int k = 1; k <= levels; k++) {
+        double h = 1.0 / (1LL << (k - 1));
+        R[k][0] = 0.5 * (R[k - 1][0] + h * level_sum[k]);
+        double factor = 4.0;
+        for (int j = 1; j <= k; j++) {
+            R[k][j] = R[k][j - 1] + (R[k][j - 1] - R[k - 1][j - 1]) / (factor - 1.0);
+            factor *= 4.0;
+        }
+    }
+    return R[levels][levels];
+}
 
 int main(int argc, char* argv[]) {
     int rank, size_mpi;
@@ -12,17 +57,18 @@ int main(int argc, char* argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
 
-    if (argc != 2) {
+    if (argc < 2 || argc > 3) {
         if (rank == 0)
-            printf("Usage: %s <N>\n", argv[0]);
+            printf("Usage: %s <N> [gauss_panels]\n", argv[0]);
         MPI_Finalize();
         return 1;
     }
 
     N = atoll(argv[1]);
-    if (N <= 0) {
+    long long panels = argc > 2 ? atoll(argv[2]) : GAUSS_PANELS;
+    if (N <= 0 || panels <= 0) {
         if (rank == 0)
-            printf("N must be positive.\n");
+            printf("N and gauss_panels must be positive.\n");
         MPI_Finalize();
         return 1;
     }
@@ -41,7 +87,8 @@ int main(int argc, char* argv[]) {
         printf("Serial Pi       : %.15f\n", pi_serial);
         printf("Reference Pi    : %.15f\n", M_PI);
         printf("Serial error    : %.3e\n", fabs(pi_serial - M_PI));
-        printf("Serial time     : %f seconds\n\n", serial_time);
+        printf("Serial time     : %f seconds\n", serial_time);
+        printf("Serial evals    : %lld\n\n", N);
     }
 
     // Broadcast serial_time so all ranks have it for speedup calc
@@ -81,7 +128,45 @@ int main(int argc, char* argv[]) {
         printf("Parallel error  : %.3e\n", fabs(pi_parallel - M_PI));
         printf("Parallel time (%d procs): %f seconds\n", size_mpi, parallel_time);
         printf("Speedup         : %f\n", speedup);
-        printf("Efficiency      : %f%%\n\n", efficiency);
+        printf("Efficiency      : %f%%\n", efficiency);
+        printf("Evaluations     : %lld\n\n", N);
+    }
+
+    // Gauss-Legendre: panels of GAUSS_POINTS each, a contiguous block per rank
+    double gx[GAUSS_POINTS], gw[GAUSS_POINTS];
+    quad_gauss_init(GAUSS_POINTS, gx, gw);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double gauss_start = MPI_Wtime();
+    double gauss_local = pi_f_gauss_range(0.0, 1.0, panels, panels * rank / size_mpi,
+                                          panels * (rank + 1) / size_mpi,
+                                          GAUSS_POINTS, gx, gw);
+    double gauss_sum = 0.0;
+    MPI_Reduce(&gauss_local, &gauss_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double gauss_time = MPI_Wtime() - gauss_start;
+
+    // Romberg extrapolation of the trapezoid rule
+    MPI_Barrier(MPI_COMM_WORLD);
+    double romberg_start = MPI_Wtime();
+    long long romberg_evals;
+    double romberg = romberg_mpi(ROMBERG_LEVELS, rank, size_mpi, &romberg_evals);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double romberg_time = MPI_Wtime() - romberg_start;
+
+    if (rank == 0) {
+        double pi_gauss = 4.0 * gauss_sum;
+        double pi_romberg = 4.0 * romberg;
+
+        printf("Gauss-Legendre Pi   : %.15f\n", pi_gauss);
+        printf("Gauss-Legendre error: %.3e\n", fabs(pi_gauss - M_PI));
+        printf("Gauss-Legendre time : %f seconds\n", gauss_time);
+        printf("Gauss-Legendre evals: %lld\n\n", panels * GAUSS_POINTS);
+
+        printf("Romberg Pi          : %.15f\n", pi_romberg);
+        printf("Romberg error       : %.3e\n", fabs(pi_romberg - M_PI));
+        printf("Romberg time        : %f seconds\n", romberg_time);
+        printf("Romberg evals       : %lld\n\n", romberg_evals);
     }
 
     MPI_Finalize();
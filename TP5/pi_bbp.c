@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+// Hexadecimal digits of pi at arbitrary positions (Bailey-Borwein-Plouffe).
+// Work units are blocks of positions; the cost of a unit grows with its
+// position, so a static split is unbalanced. Rank 0 is a master handing out
+// units on request, ranks 1..p-1 are workers (rank 0 computes alone when
+// p == 1). Inside a rank, the long modular sum of each evaluation is split
+// across OpenMP threads.
+// Build: mpicc -O2 -march=native -fopenmp pi_bbp.c -o pi_bbp -lm
+// Usage: mpirun -np <p> ./pi_bbp [start_position] [num_digits]
+
+#define DIGITS_PER_EVAL 6       // hex digits trusted from one double evaluation
+#define EVALS_PER_UNIT 4
+#define UNIT_DIGITS (DIGITS_PER_EVAL * EVALS_PER_UNIT)
+
+#define TAG_REQUEST 1
+#define TAG_WORK    2
+#define TAG_RESULT  3
+#define TAG_STOP    4
+
+#define LANES 8
+
+// 16^e[l] mod m[l] for LANES independent (e, m) pairs, in double arithmetic.
+// For m < 2^26, r*r*16 < 2^56 is exact (16 is a power of two) and the fma
+// residual p - q*m is exact too, so no integer division is needed. The bit
+// loop is branch-free and the lanes are independent, so it vectorizes.
+void pow16_mod_lanes(const uint64_t *e, const double *m, double *out) {
+    double r[LANES], inv[LANES];
+    uint64_t emax = 0;
+    for (int l = 0; l < LANES; l++) {
+        r[l] = 1.0;
+        inv[l] = 1.0 / m[l];
+        if (e[l] > emax) emax = e[l];
+    }
+    int bit = 63;
+    while (bit >= 0 && !((emax >> bit) & 1)) bit--;
+    for (; bit >= 0; bit--) {
+        for (int l = 0; l < LANES; l++) {
+            double f = ((e[l] >> bit) & 1) ? 16.0 : 1.0;
+            double p = r[l] * r[l] * f;
+            double q = floor(p * inv[l]);
+            double x = fma(-q, m[l], p);
+            x += (x < 0.0) ? m[l] : 0.0;
+            x -= (x >= m[l]) ? m[l] : 0.0;
+            r[l] = x;
+        }
+    }
+    for (int l = 0; l < LANES; l++)
+        out[l] = (m[l] == 1.0) ? 0.0 : r[l];
+}
+
+// frac( sum_k 16^(d-k) / (8k+j) )
+double bbp_series(int j, uint64_t d) {
+    int max_t = omp_get_max_threads();
+    double *partial = calloc(max_t, sizeof(double));
+    uint64_t nblocks = (d + LANES) / LANES;     // covers k = 0..d
+
+    // Left part, k = 0..d: modular terms, fractional part kept per thread
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        double s = 0.0;
+        #pragma omp for schedule(static)
+        for (uint64_t blk = 0; blk < nblocks; blk++) {
+            uint64_t e[LANES];
+            double m[LANES], t[LANES];
+            for (int l = 0; l < LANES; l++) {
+                uint64_t k = blk * LANES + l;
+                // lanes past k = d get 16^0 mod 1 = 0
+                e[l] = (k <= d) ? d - k : 0;
+                m[l] = (k <= d) ? (double)(8 * k + j) : 1.0;
+            }
+            pow16_mod_lanes(e, m, t);
+            for (int l = 0; l < LANES; l++) {
+                s += t[l] / m[l];
+                s -= floor(s);
+            }
+        }
+        partial[id] = s;
+    }
+
+    double s = 0.0;
+    for (int t = 0; t < max_t; t++) {
+        s += partial[t];
+        s -= floor(s);
+    }
+    free(partial);
+
+    // Right tail, k > d: terms shrink by 16 each step
+    double p = 1.0 / 16.0;
+    for (uint64_t k = d + 1; k <= d + 20; k++) {
+        s += p / (8 * k + j);
+        p /= 16.0;
+    }
+    return s - floor(s);
+}
+
+// Writes DIGITS_PER_EVAL hex digits starting after position d into out
+void bbp_digits(uint64_t d, char *out) {
+    static const char hex[] = "0123456789ABCDEF";
+    double x = 4.0 * bbp_series(1, d) - 2.0 * bbp_series(4, d)
+             - bbp_series(5, d) - bbp_series(6, d);
+    x -= floor(x);
+    for (int i = 0; i < DIGITS_PER_EVAL; i++) {
+        x *= 16.0;
+        int digit = (int)x;
+        out[i] = hex[digit];
+        x -= digit;
+    }
+}
+
+void compute_unit(uint64_t start, long long unit, char *out) {
+    for (int e = 0; e < EVALS_PER_UNIT; e++)
+        bbp_digits(start + (uint64_t)unit * UNIT_DIGITS + e * DIGITS_PER_EVAL,
+                   out + e * DIGITS_PER_EVAL);
+}
+
+int main(int argc, char* argv[]) {
+    int rank, size_mpi;
+    uint64_t start = 0;
+    long long num_digits = 10000;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
+
+    if (argc > 1) start = strtoull(argv[1], NULL, 10);
+    if (argc > 2) num_digits = atoll(argv[2]);
+    // pow16_mod needs 8k + j < 2^26
+    if (num_digits <= 0 || start + num_digits + UNIT_DIGITS >= (1ULL << 23)) {
+        if (rank == 0)
+            printf("Number of digits must be positive and positions below 2^23.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    long long num_units = (num_digits + UNIT_DIGITS - 1) / UNIT_DIGITS;
+    char buffer[UNIT_DIGITS];
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+
+    if (rank == 0) {
+        char *digits = malloc(num_units * UNIT_DIGITS + 1);
+        long long *units_done = calloc(size_mpi, sizeof(long long));
+        if (!digits || !units_done) {
+            fprintf(stderr, "Malloc failed\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+
+        if (size_mpi == 1) {
+            for (long long u = 0; u < num_units; u++)
+                compute_unit(start, u, digits + u * UNIT_DIGITS);
+            units_done[0] = num_units;
+        } else {
+            // Master: answer requests until every unit is back, then stop workers
+            long long next = 0, received = 0;
+            int stopped = 0;
+            while (stopped < size_mpi - 1) {
+                MPI_Status status;
+                long long msg[1 + UNIT_DIGITS / sizeof(long long) + 1];
+                MPI_Recv(msg, sizeof(msg), MPI_BYTE, MPI_ANY_SOURCE, MPI_ANY_TAG,
+                         MPI_COMM_WORLD, &status);
+                int worker = status.MPI_SOURCE;
+                if (status.MPI_TAG == TAG_RESULT) {
+                    memcpy(digits + msg[0] * UNIT_DIGITS, &msg[1], UNIT_DIGITS);
+                    units_done[worker]++;
+                    received++;
+                }
+                if (next < num_units) {
+                    MPI_Send(&next, 1, MPI_LONG_LONG, worker, TAG_WORK, MPI_COMM_WORLD);
+                    next++;
+                } else {
+                    MPI_Send(&next, 1, MPI_LONG_LONG, worker, TAG_STOP, MPI_COMM_WORLD);
+                    stopped++;
+                }
+            }
+            if (received != num_units)
+                fprintf(stderr, "Missing units: %lld of %lld\n", num_units - received, num_units);
+        }
+
+        double elapsed = MPI_Wtime() - t0;
+        digits[num_digits] = '\0';
+
+        printf("Hex digits of pi from position %llu (%lld digits, %d procs, %d threads/proc)\n",
+               (unsigned long long)start, num_digits, size_mpi, omp_get_max_threads());
+        printf("First digits    : %.48s\n", digits);
+        if (start == 0)
+            printf("Check           : %s\n",
+                   strncmp(digits, "243F6A8885A308D313198A2E03707344", num_digits < 32 ? num_digits : 32) == 0
+                   ? "matches known expansion" : "MISMATCH");
+        printf("Time            : %f seconds\n", elapsed);
+        printf("Digits/second   : %.1f\n", num_digits / elapsed);
+        printf("Units per rank  :");
+        for (int r = 0; r < size_mpi; r++) printf(" %lld", units_done[r]);
+        printf("\n");
+
+        free(digits);
+        free(units_done);
+    } else {
+        // Worker: request, compute, send result together with the next request
+        long long msg[1 + UNIT_DIGITS / sizeof(long long) + 1];
+        MPI_Send(msg, 0, MPI_BYTE, 0, TAG_REQUEST, MPI_COMM_WORLD);
+        for (;;) {
+            long long unit;
+            MPI_Status status;
+            MPI_Recv(&unit, 1, MPI_LONG_LONG, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+            if (status.MPI_TAG == TAG_STOP) break;
+            compute_unit(start, unit, buffer);
+            msg[0] = unit;
+            memcpy(&msg[1], buffer, UNIT_DIGITS);
+            MPI_Send(msg, sizeof(long long) + UNIT_DIGITS, MPI_BYTE, 0, TAG_RESULT, MPI_COMM_WORLD);
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+// Monte Carlo pi with counter-based random streams (Philox4x32-10).
+// Every (rank, thread) pair owns an independent stream: the Philox key is
+// its stream id, the counter is the block index, so no state is shared and
+// streams never overlap. LANES counters are processed together in plain
+// arrays, which the compiler turns into SIMD (32x32->64 multiplies).
+// Hit counts stay in per-thread registers and are combined with an OpenMP
+// reduction and MPI_Reduce, no atomics.
+// Build: mpicc -O3 -march=native -fopenmp pi_montecarlo.c -o pi_montecarlo -lm
+// Usage: mpirun -np <p> ./pi_montecarlo <samples_per_rank> [max_threads]
+
+#define LANES 8
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+// Philox4x32-10 on LANES counters at once; out[w][l] is word w of lane l
+void philox4x32_lanes(const uint32_t *ctr0, const uint32_t *ctr1, uint32_t k0, uint32_t k1,
+                      uint32_t out[4][LANES]) {
+    uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+    for (int l = 0; l < LANES; l++) {
+        c0[l] = ctr0[l];
+        c1[l] = ctr1[l];
+        c2[l] = 0;
+        c3[l] = 0;
+    }
+    for (int r = 0; r < 10; r++) {
+        for (int l = 0; l < LANES; l++) {
+            uint64_t p0 = (uint64_t)PHILOX_M0 * c0[l];
+            uint64_t p1 = (uint64_t)PHILOX_M1 * c2[l];
+            uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+            uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+            c1[l] = (uint32_t)p1;
+            c3[l] = (uint32_t)p0;
+            c0[l] = n0;
+            c2[l] = n2;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (int l = 0; l < LANES; l++) {
+        out[0][l] = c0[l];
+        out[1][l] = c1[l];
+        out[2][l] = c2[l];
+        out[3][l] = c3[l];
+    }
+}
+
+// Known-answer test: ctr = 0, key = 0 (Random123 test vector)
+int philox_self_test(void) {
+    uint32_t zero[LANES] = {0}, out[4][LANES];
+    philox4x32_lanes(zero, zero, 0, 0, out);
+    return out[0][0] == 0x6627e8d5u && out[1][0] == 0xe169c58du &&
+           out[2][0] == 0xbc57ac4cu && out[3][0] == 0x9b00dbd8u;
+}
+
+// Count hits in the quarter circle for `blocks` blocks of stream `stream`.
+// Each Philox call yields 4 words = 2 points per lane.
+uint64_t count_hits(uint64_t stream, uint64_t blocks) {
+    const double scale = 1.0 / 4294967296.0;
+    uint32_t k0 = (uint32_t)stream, k1 = (uint32_t)(stream >> 32);
+    uint32_t ctr0[LANES], ctr1[LANES], out[4][LANES];
+    uint64_t hits = 0;
+
+    for (uint64_t b = 0; b < blocks; b++) {
+        for (int l = 0; l < LANES; l++) {
+            uint64_t c = b * LANES + l;
+            ctr0[l] = (uint32_t)c;
+            ctr1[l] = (uint32_t)(c >> 32);
+        }
+        philox4x32_lanes(ctr0, ctr1, k0, k1, out);
+        for (int l = 0; l < LANES; l++) {
+            double x0 = out[0][l] * scale, y0 = out[1][l] * scale;
+            double x1 = out[2][l] * scale, y1 = out[3][l] * scale;
+            hits += (x0 * x0 + y0 * y0 < 1.0) + (x1 * x1 + y1 * y1 < 1.0);
+        }
+    }
+    return hits;
+}
+
+int main(int argc, char* argv[]) {
+    int rank, size_mpi;
+    long long samples;
+    int max_threads = omp_get_max_threads();
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
+
+    if (argc < 2) {
+        if (rank == 0)
+            printf("Usage: %s <samples_per_rank> [max_threads]\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    samples = atoll(argv[1]);
+    if (argc > 2) max_threads = atoi(argv[2]);
+    if (samples <= 0 || max_threads <= 0) {
+        if (rank == 0)
+            printf("Samples and threads must be positive.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (!philox_self_test()) {
+        if (rank == 0)
+            printf("Philox known-answer test failed.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (rank == 0)
+        printf("Procs,Threads,Samples,Pi,Error,Time_s,Samples_per_s\n");
+
+    for (int t = 1; t <= max_threads; t *= 2) {
+        omp_set_num_threads(t);
+        uint64_t local_hits = 0, total_hits = 0;
+        uint64_t local_samples = 0;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+
+        #pragma omp parallel reduction(+:local_hits, local_samples)
+        {
+            int id = omp_get_thread_num();
+            int nt = omp_get_num_threads();
+            // 2 * LANES samples per block, blocks split evenly between threads
+            uint64_t total_blocks = (samples + 2 * LANES - 1) / (2 * LANES);
+            uint64_t blocks = total_blocks / nt + ((uint64_t)id < total_blocks % nt ? 1 : 0);
+            uint64_t stream = ((uint64_t)rank << 16) | (uint64_t)id;
+            local_hits += count_hits(stream, blocks);
+            local_samples += blocks * 2 * LANES;
+        }
+
+        uint64_t total_samples = 0;
+        MPI_Reduce(&local_hits, &total_hits, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&local_samples, &total_samples, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+        double elapsed = MPI_Wtime() - start;
+
+        if (rank == 0) {
+            double pi = 4.0 * (double)total_hits / (double)total_samples;
+            printf("%d,%d,%llu,%.10f,%.3e,%.6f,%.3e\n", size_mpi, t,
+                   (unsigned long long)total_samples, pi, fabs(pi - M_PI), elapsed,
+                   total_samples / elapsed);
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
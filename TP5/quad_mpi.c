@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mpi.h>
+#include "../TP3/quadrature.h"
+
+// MPI back end of the quadrature engine (TP3/quadrature.h).
+// Each rank takes a contiguous block of panels, calls the *_range rule on it
+// (OpenMP + SIMD inside the rank when built with -fopenmp) and the partial
+// results are combined with MPI_Allreduce. n is doubled until the error on
+// pi drops below tol, so the rows compare time to reach that accuracy.
+// Build: mpicc -O2 -march=native -fopenmp quad_mpi.c -o quad_mpi -lm
+// Usage: mpirun -np <p> ./quad_mpi [tol]
+
+QUAD_DEFINE(pi4, 4.0 / (1.0 + x * x))
+
+#define MAX_N (1LL << 34)
+
+double gx[8], gw[8];
+
+double rule_block(int rule, long long n, long long i0, long long i1) {
+    switch (rule) {
+    case 0: return pi4_midpoint_range(0.0, 1.0, n, i0, i1);
+    case 1: return pi4_simpson_range(0.0, 1.0, n, i0, i1);
+    default: return pi4_gauss_range(0.0, 1.0, n, i0, i1, 8, gx, gw);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int rank, size_mpi;
+    double tol = 1e-12;
+    const char *names[] = {"midpoint", "simpson", "gauss8"};
+    const long long evals_per_panel[] = {1, 2, 8};
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
+
+    if (argc > 1) tol = atof(argv[1]);
+    quad_gauss_init(8, gx, gw);
+
+    if (rank == 0)
+        printf("Rule,Procs,Tol,N,Evals,Error,Time_final_s,Time_search_s\n");
+
+    for (int rule = 0; rule < 3; rule++) {
+        long long n = 1;
+        double result = 0.0, t_final = 0.0;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        double t_search = MPI_Wtime();
+        for (;;) {
+            // Contiguous block, rank < extra gets one extra panel
+            long long base  = n / size_mpi;
+            long long extra = n % size_mpi;
+            long long i0 = rank * base + (rank < extra ? rank : extra);
+            long long i1 = i0 + base + (rank < extra ? 1 : 0);
+
+            double t0 = MPI_Wtime();
+            double local = rule_block(rule, n, i0, i1);
+            MPI_Allreduce(&local, &result, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            t_final = MPI_Wtime() - t0;
+
+            // Same decision on every rank since result is identical everywhere
+            if (fabs(result - M_PI) <= tol || n >= MAX_N) break;
+            n *= 2;
+        }
+        t_search = MPI_Wtime() - t_search;
+
+        if (rank == 0)
+            printf("%s,%d,%.1e,%lld,%lld,%.3e,%.6f,%.6f\n", names[rule], size_mpi, tol, n,
+                   n * evals_per_panel[rule], fabs(result - M_PI), t_final, t_search);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
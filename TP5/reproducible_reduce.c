@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mpi.h>
+
+// Reproducible MPI reduction of the pi midpoint sum (same terms as Exercise5.c).
+// Each rank pre-rounds its terms onto RSUM_LEVELS fixed grids derived from the
+// global max and N, so the per-level sums are exact and MPI_SUM gives the same
+// bits whatever the number of ranks or the reduction tree.
+// Build WITHOUT -ffast-math:
+//   mpicc -O2 reproducible_reduce.c -o reproducible_reduce -lm
+// Usage: mpirun -np <p> ./reproducible_reduce <N>
+
+#define RSUM_LEVELS 3
+
+double rsum_sigma(double m, long long n) {
+    int e, lg = 0;
+    if (m == 0.0) return 0.0;
+    frexp(m, &e);
+    while ((1LL << lg) < n) lg++;
+    return ldexp(1.0, e + lg + 1);
+}
+
+void rsum_grids(double max_abs, long long n, double *sigma) {
+    double m = max_abs;
+    for (int l = 0; l < RSUM_LEVELS; l++) {
+        sigma[l] = rsum_sigma(m, n);
+        m = ldexp(sigma[l], -52);
+    }
+}
+
+void rsum_accumulate(const double *a, long long count, const double *sigma, double *acc) {
+    double s0 = sigma[0], s1 = sigma[1], s2 = sigma[2];
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0;
+
+    for (long long i = 0; i < count; i++) {
+        double x = a[i];
+        double q = (s0 + x) - s0;
+        acc0 += q; x -= q;
+        q = (s1 + x) - s1;
+        acc1 += q; x -= q;
+        q = (s2 + x) - s2;
+        acc2 += q;
+    }
+    acc[0] = acc0;
+    acc[1] = acc1;
+    acc[2] = acc2;
+}
+
+int main(int argc, char* argv[]) {
+    int rank, size_mpi;
+    long long N;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size_mpi);
+
+    if (argc != 2) {
+        if (rank == 0)
+            printf("Usage: %s <N>\n", argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    N = atoll(argv[1]);
+    if (N <= 0) {
+        if (rank == 0)
+            printf("N must be positive.\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    long long base  = N / size_mpi;
+    long long extra = N % size_mpi;
+    long long local_start = rank * base + (rank < extra ? rank : extra);
+    long long local_n     = base + (rank < extra ? 1 : 0);
+
+    // Materialize the terms so both reductions see exactly the same inputs
+    double *terms = malloc((local_n > 0 ? local_n : 1) * sizeof(double));
+    if (!terms) {
+        fprintf(stderr, "Malloc failed\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (long long i = 0; i < local_n; i++) {
+        double x = (local_start + i + 0.5) / N;
+        terms[i] = 1.0 / (1.0 + x * x);
+    }
+
+    // Native reduction
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    double local_sum = 0.0;
+    for (long long i = 0; i < local_n; i++)
+        local_sum += terms[i];
+    double native_sum = 0.0;
+    MPI_Allreduce(&local_sum, &native_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    double native_time = MPI_Wtime() - start;
+
+    // Reproducible reduction: one MAX + one SUM of RSUM_LEVELS doubles
+    MPI_Barrier(MPI_COMM_WORLD);
+    start = MPI_Wtime();
+    double local_max = 0.0, global_max = 0.0;
+    for (long long i = 0; i < local_n; i++) {
+        double v = fabs(terms[i]);
+        if (v > local_max) local_max = v;
+    }
+    MPI_Allreduce(&local_max, &global_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    double sigma[RSUM_LEVELS], acc[RSUM_LEVELS], global_acc[RSUM_LEVELS];
+    rsum_grids(global_max, N, sigma);
+    rsum_accumulate(terms, local_n, sigma, acc);
+    MPI_Allreduce(acc, global_acc, RSUM_LEVELS, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    double repro_sum = global_acc[0] + (global_acc[1] + global_acc[2]);
+    double repro_time = MPI_Wtime() - start;
+
+    if (rank == 0) {
+        double pi_native = 4.0 * native_sum / N;
+        double pi_repro  = 4.0 * repro_sum / N;
+        printf("Procs           : %d\n", size_mpi);
+        printf("Native Pi       : %.15f (%a)\n", pi_native, pi_native);
+        printf("Native error    : %.3e\n", fabs(pi_native - M_PI));
+        printf("Native time     : %f seconds\n", native_time);
+        printf("Repro Pi        : %.15f (%a)\n", pi_repro, pi_repro);
+        printf("Repro error     : %.3e\n", fabs(pi_repro - M_PI));
+        printf("Repro time      : %f seconds\n", repro_time);
+        printf("Overhead        : %.2fx\n\n", repro_time / native_time);
+    }
+
+    free(terms);
+    MPI_Finalize();
+    return 0;
+}